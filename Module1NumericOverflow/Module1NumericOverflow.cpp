@@ -1,202 +1,3529 @@
 // NumericOverflows.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
 
+#include <algorithm>    // std::fill
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <bit>          // std::popcount
+#include <cfenv>        // std::fetestexcept
+#include <chrono>       // std::chrono::steady_clock
+#include <cmath>        // std::isinf
+#include <compare>      // std::strong_ordering
+#include <condition_variable> // std::condition_variable_any
+#include <cstdint>      // std::uintmax_t
+#include <cstring>      // std::memcpy, std::strcmp
+#include <functional>   // std::function
 #include <iostream>     // std::cout
 #include <limits>       // std::numeric_limits
+#include <memory>       // std::unique_ptr
+#include <mutex>        // std::mutex
+#include <random>       // std::mt19937_64
+#include <source_location> // std::source_location
+#include <span>         // std::span
+#include <sstream>      // std::ostringstream
 #include <stdexcept>    // std::exception
+#include <string>       // std::string
+#include <thread>       // std::thread
+#include <type_traits>  // std::is_integral
+#include <utility>      // std::pair
+#include <vector>       // std::vector
+
+#if defined(_MSC_VER)
+#include <intrin.h>     // _umul128, _udiv128 for wide_integer
+#endif
+#if defined(__AVX2__) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>  // AVX2 intrinsics for add_numbers_batch, _addcarry_u64 for wide_integer
+#endif
+
+/*
+   Selects how the integral kernels check for overflow. GCC and Clang provide
+   __builtin_add_overflow / __builtin_sub_overflow / __builtin_mul_overflow which
+   compile down to the arithmetic instruction followed by a jump on the overflow
+   flag. MSVC has no equivalent, so it always uses the portable limit checks.
+   Define NUMERIC_OVERFLOW_USE_BUILTINS to 0 to force the portable checks.
+*/
+#ifndef NUMERIC_OVERFLOW_USE_BUILTINS
+#if defined(__GNUC__) || defined(__clang__)
+#define NUMERIC_OVERFLOW_USE_BUILTINS 1
+#else
+#define NUMERIC_OVERFLOW_USE_BUILTINS 0
+#endif
+#endif
+
+/*
+   Selects the default policy of safe_int. Debug and canary builds keep the checks;
+   define NUMERIC_OVERFLOW_SAFE_INT_UNCHECKED to 1 in builds where safe_int should
+   compile to plain arithmetic.
+*/
+#ifndef NUMERIC_OVERFLOW_SAFE_INT_UNCHECKED
+#define NUMERIC_OVERFLOW_SAFE_INT_UNCHECKED 0
+#endif
 
 /// <summary>
-/// Template function to abstract away the logic of:
-///   start + (increment * steps)
+/// Why a checked operation failed
 /// </summary>
-/// <typeparam name="T">A type that with basic math functions</typeparam>
+enum class numeric_error
+{
+    none,
+    overflow,
+    underflow,
+    precision_loss,
+    division_by_zero,
+    count   // the number of errors above, not an error itself
+};
+
+/// <summary>
+/// The non-throwing result of a checked operation: either a value, or the reason
+/// there is no value. Hot loops that routinely hit the limits can test this
+/// instead of paying for exception unwinding and message allocation.
+/// </summary>
+/// <typeparam name="T">The type of the value</typeparam>
+template <typename T>
+struct checked_result
+{
+    T value;
+    numeric_error error;
+
+    /// <summary>
+    /// true when the operation succeeded and value is valid
+    /// </summary>
+    constexpr explicit operator bool() const
+    {
+        return error == numeric_error::none;
+    }
+};
+
+/// <summary>
+/// How many steps of magnitude fit between start and one limit of T. The distance
+/// in the direction of travel always fits in the unsigned width of T, so this is
+/// a single division.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
 /// <param name="start">The number to start with</param>
-/// <param name="increment">How much to add each step</param>
-/// <param name="steps">The number of steps to iterate</param>
-/// <returns>start + (increment * steps)</returns>
+/// <param name="magnitude">The absolute size of each step, not zero</param>
+/// <param name="ascending">true to move towards MAX, false to move towards MIN</param>
+/// <returns>The largest step count that stays in range</returns>
 template <typename T>
-T add_numbers(T const& start, T const& increment, unsigned long int const& steps)
+constexpr std::uintmax_t integral_headroom_steps(T const& start, std::uintmax_t const& magnitude, bool const& ascending)
 {
-    T result = start;
+    using wide = std::uintmax_t;
+
+    // unsigned wrap-around gives the true distance even when start is negative
+    const wide headroom = ascending
+        ? wide(std::numeric_limits<T>::max()) - wide(start)
+        : wide(start) - wide(std::numeric_limits<T>::min());
+
+    return headroom / magnitude;
+}
+
+/// <summary>
+/// Closed-form evaluation of start +/- (magnitude * steps) for integral types.
+/// The distance from start to the limit in the direction of travel always fits in
+/// the unsigned width of T, so a single division tells us how many steps are safe.
+/// Because every step moves the same way, the final value is out of range exactly
+/// when one of the intermediate values would have been, so this matches the
+/// per-step loop without iterating.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="magnitude">The absolute size of each step</param>
+/// <param name="ascending">true to move towards MAX, false to move towards MIN</param>
+/// <param name="steps">The number of steps to take</param>
+/// <returns>start +/- (magnitude * steps), or the wrapped value and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> integral_multiply_accumulate_portable(T const& start, std::uintmax_t const& magnitude, bool const& ascending, unsigned long int const& steps)
+{
+    using wide = std::uintmax_t;
 
-    for (unsigned long int i = 0; i < steps; ++i)
+    if (magnitude == 0)
     {
-        /*
-        ------------------------------------------CHANGES---------------------------------------------------------------------------
-           To detect whether an overflow is about to happen, the result must be greater than the difference of MAX and the increment
-           in the case of signed char, if result = 125, increment = 25, and MAX = 127, then:
-           
-           25 > 0 TRUE
-           125 > 127 - 25 = 102 TRUE
-           
-           thus adding 25 to 125 will result in an overflow
-        ----------------------------------------------------------------------------------------------------------------------------
-        */
+        return { start, numeric_error::none };
+    }
 
-        // adding a postive number unitl overlfow
-        if (increment > 0 && result > std::numeric_limits<T>::max() - increment)
-        {
-            // if an overflow has occured throw an exception
-            throw std::overflow_error("ERROR: Numeric overflow has occured!");
-        }
-        // adding a negative number which results in subtraction until underflow
-        else if (increment < 0 && result < std::numeric_limits<T>::min() - increment)
+    const bool out_of_range = wide(steps) > integral_headroom_steps<T>(start, magnitude, ascending);
+
+    // when in range the product is at most headroom, so the truncation back to T is
+    // exact; otherwise this is the two's complement wrapped value for wrap_policy
+    const wide delta = magnitude * wide(steps);
+    const T result = static_cast<T>(ascending ? wide(start) + delta : wide(start) - delta);
+
+    if (out_of_range)
+    {
+        return { result, ascending ? numeric_error::overflow : numeric_error::underflow };
+    }
+    return { result, numeric_error::none };
+}
+
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+/// <summary>
+/// Same contract as integral_multiply_accumulate_portable, but uses the compiler's
+/// checked multiply and add/sub so the common case is two flag tests and no division.
+/// When (magnitude * steps) does not fit in T on its own the start value may still
+/// bring the result back into range, so that rare case is handed to the portable
+/// version, which also makes the reported errors identical between backends.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="magnitude">The absolute size of each step</param>
+/// <param name="ascending">true to move towards MAX, false to move towards MIN</param>
+/// <param name="steps">The number of steps to take</param>
+/// <returns>start +/- (magnitude * steps), or the wrapped value and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> integral_multiply_accumulate_builtin(T const& start, std::uintmax_t const& magnitude, bool const& ascending, unsigned long int const& steps)
+{
+    T delta;
+    T result;
+
+    if (!__builtin_mul_overflow(magnitude, steps, &delta))
+    {
+        const bool out_of_range = ascending
+            ? __builtin_add_overflow(start, delta, &result)
+            : __builtin_sub_overflow(start, delta, &result);
+
+        if (!out_of_range)
         {
-            throw std::underflow_error("ERROR: Numeric underflow has occured!");
+            return { result, numeric_error::none };
         }
-        result += increment;
     }
-    return result;
+    return integral_multiply_accumulate_portable<T>(start, magnitude, ascending, steps);
 }
+#endif
 
 /// <summary>
-/// Template function to abstract away the logic of:
-///   start - (increment * steps)
+/// The absolute value of an integral step as an unsigned number, which is
+/// representable even for MIN of a signed type.
 /// </summary>
-/// <typeparam name="T">A type that with basic math functions</typeparam>
-/// <param name="start">The number to start with</param>
-/// <param name="increment">How much to subtract each step</param>
-/// <param name="steps">The number of steps to iterate</param>
-/// <returns>start - (increment * steps)</returns>
+template <typename T>
+constexpr std::uintmax_t integral_magnitude(T const& value)
+{
+    return value < 0 ? std::uintmax_t(0) - std::uintmax_t(value) : std::uintmax_t(value);
+}
 
+/// <summary>
+/// Dispatches to the checked arithmetic backend selected by NUMERIC_OVERFLOW_USE_BUILTINS.
+/// </summary>
 template <typename T>
-T subtract_numbers(T const& start, T const& decrement, unsigned long int const& steps)
+constexpr checked_result<T> integral_multiply_accumulate(T const& start, std::uintmax_t const& magnitude, bool const& ascending, unsigned long int const& steps)
 {
-    T result = start;
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    return integral_multiply_accumulate_builtin<T>(start, magnitude, ascending, steps);
+#else
+    return integral_multiply_accumulate_portable<T>(start, magnitude, ascending, steps);
+#endif
+}
 
-    /*
-     ------------------------------------------CHANGES------------------------------------------------------------------------
-           To detect whether an underflow is about to happen, the result must be smaller than the sum of MIN and the decrement
-           in the case of unsigned char, if result = 0, increment = 51, and MIN = 0, then:
+/*
+   Fixed width integers wider than long long, built from 64 bit limbs. Addition
+   and subtraction run a carry chain through the limbs, which maps onto the
+   add-with-carry instructions via _addcarry_u64 / _subborrow_u64 on x64. The
+   numeric_limits specialization below lets them plug into add_numbers,
+   subtract_numbers and the test templates like any built-in integer.
+*/
 
-           51 > 0 TRUE
-           0 < 0 + 25 = 25 TRUE
+#if defined(__x86_64__) || defined(_M_X64)
+#define WIDE_INTEGER_USE_X64_INTRINSICS 1
+#else
+#define WIDE_INTEGER_USE_X64_INTRINSICS 0
+#endif
 
-           thus subtracting 25 from 0 will result in an underflow
-    --------------------------------------------------------------------------------------------------------------------------
-    */
+/// <summary>
+/// out = a + b + carry_in, returning the carry out of the limb.
+/// The inputs are taken by value because out is often one of them.
+/// </summary>
+constexpr unsigned char add_with_carry(std::uint64_t a, std::uint64_t b, unsigned char carry_in, std::uint64_t& out)
+{
+#if WIDE_INTEGER_USE_X64_INTRINSICS
+    if (!std::is_constant_evaluated())
+    {
+        unsigned long long sum;
+        const unsigned char carry = _addcarry_u64(carry_in, a, b, &sum);
+        out = sum;
+        return carry;
+    }
+#endif
+    const std::uint64_t partial = a + b;
+    out = partial + carry_in;
+    return static_cast<unsigned char>((partial < a) | (out < partial));
+}
+
+/// <summary>
+/// out = a - b - borrow_in, returning the borrow out of the limb.
+/// The inputs are taken by value because out is often one of them.
+/// </summary>
+constexpr unsigned char subtract_with_borrow(std::uint64_t a, std::uint64_t b, unsigned char borrow_in, std::uint64_t& out)
+{
+#if WIDE_INTEGER_USE_X64_INTRINSICS
+    if (!std::is_constant_evaluated())
+    {
+        unsigned long long difference;
+        const unsigned char borrow = _subborrow_u64(borrow_in, a, b, &difference);
+        out = difference;
+        return borrow;
+    }
+#endif
+    const std::uint64_t partial = a - b;
+    out = partial - borrow_in;
+    return static_cast<unsigned char>((a < b) | (partial < borrow_in));
+}
+
+/// <summary>
+/// The full 128 bit product of two limbs, returning the low half
+/// </summary>
+constexpr std::uint64_t multiply_limbs(std::uint64_t a, std::uint64_t b, std::uint64_t& high)
+{
+    if (!std::is_constant_evaluated())
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        high = static_cast<std::uint64_t>(product >> 64);
+        return static_cast<std::uint64_t>(product);
+#elif defined(_M_X64)
+        unsigned long long product_high;
+        const std::uint64_t low = _umul128(a, b, &product_high);
+        high = product_high;
+        return low;
+#endif
+    }
+
+    // schoolbook multiply on 32 bit halves
+    const std::uint64_t a_low = a & 0xFFFFFFFFu, a_high = a >> 32;
+    const std::uint64_t b_low = b & 0xFFFFFFFFu, b_high = b >> 32;
+    const std::uint64_t low_low = a_low * b_low;
+    const std::uint64_t middle = (low_low >> 32) + (a_high * b_low & 0xFFFFFFFFu) + a_low * b_high;
+    high = a_high * b_high + (a_high * b_low >> 32) + (middle >> 32);
+    return (middle << 32) | (low_low & 0xFFFFFFFFu);
+}
+
+/// <summary>
+/// Divides the 128 bit number (high:low) by divisor, which must be larger than high
+/// </summary>
+/// <returns>The 64 bit quotient</returns>
+constexpr std::uint64_t divide_limbs(std::uint64_t high, std::uint64_t low, std::uint64_t divisor, std::uint64_t& remainder)
+{
+    if (!std::is_constant_evaluated())
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 dividend = (static_cast<unsigned __int128>(high) << 64) | low;
+        remainder = static_cast<std::uint64_t>(dividend % divisor);
+        return static_cast<std::uint64_t>(dividend / divisor);
+#elif defined(_M_X64)
+        unsigned long long rest;
+        const std::uint64_t quotient = _udiv128(high, low, divisor, &rest);
+        remainder = rest;
+        return quotient;
+#endif
+    }
 
-    for (unsigned long int i = 0; i < steps; ++i) 
+    // restoring division one bit at a time
+    std::uint64_t rest = high;
+    std::uint64_t quotient = 0;
+    for (int bit = 63; bit >= 0; --bit)
     {
-        // subtraction of a positive number
-        if (decrement > 0 && result < std::numeric_limits<T>::min() + decrement)
+        const bool carry = (rest >> 63) != 0;
+        rest = (rest << 1) | ((low >> bit) & 1);
+        if (carry || rest >= divisor)
         {
-            // if an underflow has occured throw an exception
-            throw std::underflow_error("ERROR: Numeric underflow has occured!");
+            rest -= divisor;
+            quotient |= std::uint64_t(1) << bit;
         }
-        // subtraction of a negative number which results in addition
-        else if (decrement < 0 && result > std::numeric_limits<T>::max() + decrement)
+    }
+    remainder = rest;
+    return quotient;
+}
+
+/// <summary>
+/// A two's complement integer of Limbs * 64 bits, least significant limb first.
+/// Arithmetic wraps like the built-in unsigned types; the overflow checks live in
+/// the kernels, exactly as they do for the built-in types.
+/// </summary>
+/// <typeparam name="Limbs">The number of 64 bit limbs</typeparam>
+/// <typeparam name="Signed">true for a signed integer</typeparam>
+template <std::size_t Limbs, bool Signed>
+class wide_integer
+{
+public:
+    static_assert(Limbs >= 2, "use the built-in types for 64 bits or less");
+
+    std::uint64_t limbs[Limbs];
+
+    constexpr wide_integer() : limbs{} {}
+
+    /// <summary>
+    /// Converts from a built-in integer, sign extending negative values
+    /// </summary>
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    constexpr wide_integer(I const& value) : limbs{}
+    {
+        bool negative = false;
+        if constexpr (std::is_signed<I>::value)
         {
-            throw std::overflow_error("ERROR: Numeric overflow has occured!");
+            negative = value < 0;
+        }
+        limbs[0] = static_cast<std::uint64_t>(value);
+        for (std::size_t i = 1; i < Limbs; ++i)
+        {
+            limbs[i] = negative ? ~std::uint64_t(0) : 0;
         }
-        result = result -= decrement;
     }
-    return result;
-}
 
+    /// <summary>
+    /// Reinterprets the bits of the other signedness, like a cast between int and unsigned int
+    /// </summary>
+    template <bool OtherSigned, typename = std::enable_if_t<OtherSigned != Signed>>
+    explicit constexpr wide_integer(wide_integer<Limbs, OtherSigned> const& other) : limbs{}
+    {
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            limbs[i] = other.limbs[i];
+        }
+    }
 
-//  NOTE:
-//    You will see the unary ('+') operator used in front of the variables in the test_XXX methods.
-//    This forces the output to be a number for cases where cout would assume it is a character. 
+    /// <summary>
+    /// Truncates to a built-in integer
+    /// </summary>
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    explicit constexpr operator I() const
+    {
+        return static_cast<I>(limbs[0]);
+    }
 
-template <typename T>
-void test_overflow()
-{
-    // TODO: The add_numbers template function will overflow in the second method call
-    //        You need to change the add_numbers method to:
-    //        1. Detect when an overflow will happen
-    //        2. Prevent it from happening
-    //        3. Return the correct value when no overflow happened or
-    //        4. Return something to tell test_overflow the addition failed
-    //        NOTE: The add_numbers method must remain a template in the NumericFunctions header.
-    //
-    //        You need to change the test_overflow method to:
-    //        1. Detect when an add_numbers failed
-    //        2. Inform the user the overflow happened
-    //        3. A successful result displays the same result as before you changed the method
-    //        NOTE: You cannot change anything between START / END DO NOT CHANGE
-    //              The test_overflow method must remain a template in the NumericOverflows source file
-    //
-    //  There are more than one possible solution to this problem. 
-    //  The solution must work for all of the data types used to call test_overflow() in main().
+    constexpr bool is_negative() const
+    {
+        return Signed && (limbs[Limbs - 1] >> 63) != 0;
+    }
 
-    // START DO NOT CHANGE
-    //  how many times will we iterate
-    const unsigned long int steps = 5;
-    // how much will we add each step (result should be: start + (increment * steps))
-    const T increment = std::numeric_limits<T>::max() / steps;
-    // whats our starting point
-    const T start = 0;
+    /// <summary>
+    /// result = a + b through the carry chain
+    /// </summary>
+    /// <returns>The carry out of the top limb</returns>
+    static constexpr bool add_carry(wide_integer const& a, wide_integer const& b, wide_integer& result)
+    {
+        unsigned char carry = 0;
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            carry = add_with_carry(a.limbs[i], b.limbs[i], carry, result.limbs[i]);
+        }
+        return carry != 0;
+    }
 
-    std::cout << "Overflow Test of Type = " << typeid(T).name() << std::endl;
-    // END DO NOT CHANGE
+    /// <summary>
+    /// result = a - b through the borrow chain
+    /// </summary>
+    /// <returns>The borrow out of the top limb</returns>
+    static constexpr bool subtract_borrow(wide_integer const& a, wide_integer const& b, wide_integer& result)
+    {
+        unsigned char borrow = 0;
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            borrow = subtract_with_borrow(a.limbs[i], b.limbs[i], borrow, result.limbs[i]);
+        }
+        return borrow != 0;
+    }
+
+    /// <summary>
+    /// result = a * b treating a as unsigned
+    /// </summary>
+    /// <returns>true if the product did not fit in Limbs limbs</returns>
+    static constexpr bool multiply_carry(wide_integer const& a, std::uint64_t const& b, wide_integer& result)
+    {
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            std::uint64_t high = 0;
+            const std::uint64_t low = multiply_limbs(a.limbs[i], b, high);
+            high += add_with_carry(low, carry, 0, result.limbs[i]);
+            carry = high;
+        }
+        return carry != 0;
+    }
 
+    /// <summary>
+    /// result = a / b treating a as unsigned
+    /// </summary>
+    /// <returns>The remainder</returns>
+    static constexpr std::uint64_t divide_unsigned(wide_integer const& a, std::uint64_t const& b, wide_integer& result)
+    {
+        std::uint64_t remainder = 0;
+        for (std::size_t i = Limbs; i-- > 0; )
+        {
+            result.limbs[i] = divide_limbs(remainder, a.limbs[i], b, remainder);
+        }
+        return remainder;
+    }
 
-    /*
-    * -------------------------CHANGES-----------------------------------------------
-        Try to add the numbers and catch an overflow, underflow, or unkown exception
-        and handle it by printing an error message to the console
-     --------------------------------------------------------------------------------
-    */
+    constexpr wide_integer operator+() const
+    {
+        return *this;
+    }
 
-    // No overflow test
-    T result;
-    std::cout << "\tAdding Numbers Without Overflow (" << +start << ", " << +increment << ", " << steps << ") = ";
-   
-    try
+    constexpr wide_integer operator-() const
     {
-        result = add_numbers<T>(start, increment, steps); // Attempt to add the numbers
-        std::cout << +result << '\n'; // Display the result of the addition
+        wide_integer result;
+        subtract_borrow(wide_integer(), *this, result);
+        return result;
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+
+    constexpr wide_integer& operator+=(wide_integer const& other)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        add_carry(*this, other, *this);
+        return *this;
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+
+    constexpr wide_integer& operator-=(wide_integer const& other)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        subtract_borrow(*this, other, *this);
+        return *this;
     }
-    catch (const std::exception& e)
+
+    friend constexpr wide_integer operator+(wide_integer a, wide_integer const& b)
     {
-        std::cout << "ERROR Unknown Addition Error " << e.what() << '\n';
+        return a += b;
     }
 
-    // Overflow test
-    std::cout << "\tAdding Numbers With Overflow (" << +start << ", " << +increment << ", " << (steps + 1) << ") = ";
-   
-    try
+    friend constexpr wide_integer operator-(wide_integer a, wide_integer const& b)
     {
-        result = add_numbers<T>(start, increment, steps + 1); // Attempt to add the numbers
-        std::cout << +result; // Display the result of the addition
+        return a -= b;
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+
+    /// <summary>
+    /// Multiplication by a built-in count, wrapping like the built-in unsigned types
+    /// </summary>
+    friend constexpr wide_integer operator*(wide_integer const& a, std::uint64_t const& b)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        wide_integer result;
+        multiply_carry(a, b, result);
+        return result;
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+
+    /// <summary>
+    /// Division by a built-in count, truncating towards zero like the built-in types
+    /// </summary>
+    friend constexpr wide_integer operator/(wide_integer const& a, std::uint64_t const& b)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        wide_integer result;
+        if (a.is_negative())
+        {
+            divide_unsigned(-a, b, result);
+            return -result;
+        }
+        divide_unsigned(a, b, result);
+        return result;
     }
-    catch (const std::exception& e)
+
+    friend constexpr bool operator==(wide_integer const& a, wide_integer const& b)
     {
-        std::cout << "ERROR Unknown Addition Error " << e.what() << '\n';
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            if (a.limbs[i] != b.limbs[i])
+            {
+                return false;
+            }
+        }
+        return true;
     }
-    std::cout << '\n';
-}
 
+    friend constexpr std::strong_ordering operator<=>(wide_integer const& a, wide_integer const& b)
+    {
+        if (a.is_negative() != b.is_negative())
+        {
+            return a.is_negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        // with equal signs two's complement orders the same as unsigned
+        for (std::size_t i = Limbs; i-- > 0; )
+        {
+            if (a.limbs[i] != b.limbs[i])
+            {
+                return a.limbs[i] < b.limbs[i] ? std::strong_ordering::less : std::strong_ordering::greater;
+            }
+        }
+        return std::strong_ordering::equal;
+    }
 
-/*
-   -------------------------CHANGES---------------------------------------------------
-      Added a new template method specifically for testing signed integer overflow.
-      Can be used to check that an underflow exception is generate if add_numbers
-      is inadvertanly used to subtract numbers. Currently it is setup to test
-      the same overflow case as test_overflow()
-   -----------------------------------------------------------------------------------
-*/
-template <typename T>
-void test_overflow_signed()
+    /// <summary>
+    /// Prints the value in decimal
+    /// </summary>
+    friend std::ostream& operator<<(std::ostream& out, wide_integer const& value)
+    {
+        wide_integer rest = value.is_negative() ? -value : value;
+        std::string digits;
+        do
+        {
+            digits.insert(digits.begin(), char('0' + divide_unsigned(rest, 10, rest)));
+        } while (rest != wide_integer());
+
+        if (value.is_negative())
+        {
+            digits.insert(digits.begin(), '-');
+        }
+        return out << digits;
+    }
+};
+
+using wide_int128 = wide_integer<2, true>;
+using wide_uint128 = wide_integer<2, false>;
+using wide_int256 = wide_integer<4, true>;
+using wide_uint256 = wide_integer<4, false>;
+
+template <std::size_t Limbs, bool Signed>
+class std::numeric_limits<wide_integer<Limbs, Signed>>
 {
-    // TODO: The add_numbers template function will overflow in the second method call
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = Signed;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = !Signed;
+    static constexpr int radix = 2;
+    static constexpr int digits = int(Limbs * 64) - (Signed ? 1 : 0);
+    static constexpr int digits10 = digits * 30103 / 100000;
+
+    static constexpr wide_integer<Limbs, Signed> min()
+    {
+        wide_integer<Limbs, Signed> value;
+        if (Signed)
+        {
+            value.limbs[Limbs - 1] = std::uint64_t(1) << 63;
+        }
+        return value;
+    }
+
+    static constexpr wide_integer<Limbs, Signed> max()
+    {
+        wide_integer<Limbs, Signed> value;
+        for (std::size_t i = 0; i < Limbs; ++i)
+        {
+            value.limbs[i] = ~std::uint64_t(0);
+        }
+        if (Signed)
+        {
+            value.limbs[Limbs - 1] >>= 1;
+        }
+        return value;
+    }
+
+    static constexpr wide_integer<Limbs, Signed> lowest()
+    {
+        return min();
+    }
+};
+
+template <typename T>
+struct is_wide_integer : std::false_type {};
+
+template <std::size_t Limbs, bool Signed>
+struct is_wide_integer<wide_integer<Limbs, Signed>> : std::true_type {};
+
+/// <summary>
+/// Closed-form evaluation of start +/- (magnitude * steps) for wide integers.
+/// Works like integral_multiply_accumulate_portable, except that the wide
+/// multiply reports its own carry so no division is needed: the result is out of
+/// range when the product carries out or exceeds the headroom to the limit.
+/// </summary>
+/// <typeparam name="T">A wide_integer type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="magnitude">The absolute size of each step</param>
+/// <param name="ascending">true to move towards MAX, false to move towards MIN</param>
+/// <param name="steps">The number of steps to take</param>
+/// <returns>start +/- (magnitude * steps), or the wrapped value and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> wide_multiply_accumulate(T const& start, wide_integer<sizeof(T) / 8, false> const& magnitude, bool const& ascending, unsigned long int const& steps)
+{
+    using wide = wide_integer<sizeof(T) / 8, false>;
+
+    // unsigned wrap-around gives the true distance even when start is negative
+    const wide headroom = ascending
+        ? wide(std::numeric_limits<T>::max()) - wide(start)
+        : wide(start) - wide(std::numeric_limits<T>::min());
+
+    wide delta;
+    const bool carried = wide::multiply_carry(magnitude, steps, delta);
+    const bool out_of_range = carried || delta > headroom;
+
+    const T result = T(ascending ? wide(start) + delta : wide(start) - delta);
+    if (out_of_range)
+    {
+        return { result, ascending ? numeric_error::overflow : numeric_error::underflow };
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// The absolute value of a wide integer step as an unsigned wide integer, which is
+/// representable even for MIN of a signed type.
+/// </summary>
+template <typename T>
+constexpr wide_integer<sizeof(T) / 8, false> wide_magnitude(T const& value)
+{
+    using wide = wide_integer<sizeof(T) / 8, false>;
+    return value < 0 ? wide(-value) : wide(value);
+}
+
+/*
+   Policies decide what add_numbers and subtract_numbers do when the checked
+   result is out of range. They all share the limit checks in the kernels above
+   and only differ in how the checked_result is turned into a return value.
+*/
+
+/// <summary>
+/// Throws std::overflow_error / std::underflow_error. This is the default.
+/// In a constant expression the throw makes the evaluation ill-formed, so an
+/// out of range constant is a compile error instead of a startup failure.
+/// </summary>
+struct throw_policy
+{
+    template <typename T>
+    static constexpr T resolve(checked_result<T> const& result)
+    {
+        if (result.error == numeric_error::overflow)
+        {
+            throw std::overflow_error("ERROR: Numeric overflow has occured!");
+        }
+        if (result.error == numeric_error::underflow)
+        {
+            throw std::underflow_error("ERROR: Numeric underflow has occured!");
+        }
+        if (result.error == numeric_error::precision_loss)
+        {
+            throw std::range_error("ERROR: Numeric precision loss has occured!");
+        }
+        if (result.error == numeric_error::division_by_zero)
+        {
+            throw std::domain_error("ERROR: Division by zero has occured!");
+        }
+        return result.value;
+    }
+};
+
+/// <summary>
+/// Clamps to the limit that was crossed: numeric_limits lowest() or max(), which
+/// for real numbers are the most negative and most positive finite values. A loss
+/// of precision keeps the value that was reached and a division by zero keeps start.
+/// </summary>
+struct saturate_policy
+{
+    template <typename T>
+    static constexpr T resolve(checked_result<T> const& result)
+    {
+        // selects rather than branches so this stays cheap inside vectorized loops
+        const T limit = result.error == numeric_error::overflow ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+        const bool out_of_range = result.error == numeric_error::overflow || result.error == numeric_error::underflow;
+        return out_of_range ? limit : result.value;
+    }
+};
+
+/// <summary>
+/// Returns what the unchecked arithmetic would have produced: the two's complement
+/// wrapped value for integers and the plain IEEE result for real numbers.
+/// </summary>
+struct wrap_policy
+{
+    template <typename T>
+    static constexpr T resolve(checked_result<T> const& result)
+    {
+        return result.value;
+    }
+};
+
+/// <summary>
+/// Returns the checked_result itself so the caller can inspect the error.
+/// </summary>
+struct report_policy
+{
+    template <typename T>
+    static constexpr checked_result<T> resolve(checked_result<T> const& result)
+    {
+        return result;
+    }
+};
+
+/// <summary>
+/// Marks arithmetic that should not be checked at all. safe_int compiles its
+/// operators to plain wrapping arithmetic with this policy; anything that still
+/// runs a kernel with it gets the wrap_policy result.
+/// </summary>
+struct unchecked_policy : wrap_policy {};
+
+template <typename Policy>
+struct is_unchecked_policy : std::is_same<Policy, unchecked_policy> {};
+
+/// <summary>
+/// Whether a policy returns the unchecked value of an out of range result. Only
+/// then do the real number loops keep stepping after the first failure.
+/// </summary>
+template <typename Policy>
+struct policy_uses_unchecked_value : std::is_base_of<wrap_policy, Policy> {};
+
+#if NUMERIC_OVERFLOW_SAFE_INT_UNCHECKED
+using safe_int_default_policy = unchecked_policy;
+#else
+using safe_int_default_policy = throw_policy;
+#endif
+
+/// <summary>
+/// Non-throwing version of add_numbers:
+///   start + (increment * steps)
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Unchecked">false to stop a real number sum at the first failure instead of finishing it unchecked</typeparam>
+/// <returns>start + (increment * steps), or the unchecked result (the last value in range when Unchecked is false) and why it is out of range</returns>
+template <typename T, bool Unchecked = true>
+constexpr checked_result<T> add_numbers_checked(T const& start, T const& increment, unsigned long int const& steps)
+{
+    // integers are exact, so the answer and its overflow check can be computed directly
+    if constexpr (std::is_integral<T>::value)
+    {
+        return integral_multiply_accumulate<T>(start, integral_magnitude(increment), !(increment < 0), steps);
+    }
+    else if constexpr (is_wide_integer<T>::value)
+    {
+        return wide_multiply_accumulate<T>(start, wide_magnitude(increment), !(increment < 0), steps);
+    }
+
+    // real numbers round on every step, so they still have to be added one step at a time
+    T result = start;
+    numeric_error error = numeric_error::none;
+    unsigned long int i = 0;
+
+    for (; i < steps; ++i)
+    {
+        /*
+        ------------------------------------------CHANGES---------------------------------------------------------------------------
+           To detect whether an overflow is about to happen, the result must be greater than the difference of MAX and the increment
+           in the case of signed char, if result = 125, increment = 25, and MAX = 127, then:
+           
+           25 > 0 TRUE
+           125 > 127 - 25 = 102 TRUE
+           
+           thus adding 25 to 125 will result in an overflow
+        ----------------------------------------------------------------------------------------------------------------------------
+        */
+
+        // adding a postive number unitl overlfow
+        if (increment > 0 && result > std::numeric_limits<T>::max() - increment)
+        {
+            // if an overflow has occured report it
+            error = numeric_error::overflow;
+            break;
+        }
+        // adding a negative number which results in subtraction until underflow, against
+        // lowest() because for real numbers min() is the smallest positive value
+        else if (increment < 0 && result < std::numeric_limits<T>::lowest() - increment)
+        {
+            error = numeric_error::underflow;
+            break;
+        }
+        result += increment;
+    }
+
+    // after a failure finish with unchecked arithmetic, but only for wrap_policy, which returns it
+    if constexpr (Unchecked)
+    {
+        for (; i < steps; ++i)
+        {
+            result += increment;
+        }
+    }
+    return { result, error };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start + (increment * steps)
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>start + (increment * steps)</returns>
+template <typename T, typename Policy = throw_policy>
+constexpr auto add_numbers(T const& start, T const& increment, unsigned long int const& steps)
+{
+    return Policy::resolve(add_numbers_checked<T, policy_uses_unchecked_value<Policy>::value>(start, increment, steps));
+}
+
+/// <summary>
+/// Non-throwing version of subtract_numbers:
+///   start - (increment * steps)
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to subtract each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Unchecked">false to stop a real number sum at the first failure instead of finishing it unchecked</typeparam>
+/// <returns>start - (increment * steps), or the unchecked result (the last value in range when Unchecked is false) and why it is out of range</returns>
+template <typename T, bool Unchecked = true>
+constexpr checked_result<T> subtract_numbers_checked(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    // integers are exact, so the answer and its underflow check can be computed directly
+    if constexpr (std::is_integral<T>::value)
+    {
+        return integral_multiply_accumulate<T>(start, integral_magnitude(decrement), decrement < 0, steps);
+    }
+    else if constexpr (is_wide_integer<T>::value)
+    {
+        return wide_multiply_accumulate<T>(start, wide_magnitude(decrement), decrement < 0, steps);
+    }
+
+    // real numbers round on every step, so they still have to be subtracted one step at a time
+    T result = start;
+
+    /*
+     ------------------------------------------CHANGES------------------------------------------------------------------------
+           To detect whether an underflow is about to happen, the result must be smaller than the sum of MIN and the decrement
+           in the case of unsigned char, if result = 0, increment = 51, and MIN = 0, then:
+
+           51 > 0 TRUE
+           0 < 0 + 25 = 25 TRUE
+
+           thus subtracting 25 from 0 will result in an underflow
+    --------------------------------------------------------------------------------------------------------------------------
+    */
+
+    numeric_error error = numeric_error::none;
+    unsigned long int i = 0;
+
+    for (; i < steps; ++i) 
+    {
+        // subtraction of a positive number, against lowest() as in add_numbers_checked
+        if (decrement > 0 && result < std::numeric_limits<T>::lowest() + decrement)
+        {
+            // if an underflow has occured report it
+            error = numeric_error::underflow;
+            break;
+        }
+        // subtraction of a negative number which results in addition
+        else if (decrement < 0 && result > std::numeric_limits<T>::max() + decrement)
+        {
+            error = numeric_error::overflow;
+            break;
+        }
+        result = result -= decrement;
+    }
+
+    // after a failure finish with unchecked arithmetic, but only for wrap_policy, which returns it
+    if constexpr (Unchecked)
+    {
+        for (; i < steps; ++i)
+        {
+            result -= decrement;
+        }
+    }
+    return { result, error };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start - (increment * steps)
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to subtract each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>start - (increment * steps)</returns>
+
+template <typename T, typename Policy = throw_policy>
+constexpr auto subtract_numbers(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    return Policy::resolve(subtract_numbers_checked<T, policy_uses_unchecked_value<Policy>::value>(start, decrement, steps));
+}
+
+/// <summary>
+/// Compile-time form of add_numbers for building constant tables. The result is
+/// computed by the compiler and an out of range value fails a static_assert that
+/// names the problem, so nothing is left to check at run time.
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <typeparam name="Start">The number to start with</typeparam>
+/// <typeparam name="Increment">How much to add each step</typeparam>
+/// <typeparam name="Steps">The number of steps to iterate</typeparam>
+template <typename T, T Start, T Increment, unsigned long int Steps>
+struct add_numbers_constant
+{
+    static constexpr checked_result<T> result = add_numbers_checked<T>(Start, Increment, Steps);
+    static_assert(result.error != numeric_error::overflow, "add_numbers_constant: Numeric overflow has occured!");
+    static_assert(result.error != numeric_error::underflow, "add_numbers_constant: Numeric underflow has occured!");
+    static constexpr T value = result.value;
+};
+
+/// <summary>
+/// Compile-time form of subtract_numbers, see add_numbers_constant.
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <typeparam name="Start">The number to start with</typeparam>
+/// <typeparam name="Decrement">How much to subtract each step</typeparam>
+/// <typeparam name="Steps">The number of steps to iterate</typeparam>
+template <typename T, T Start, T Decrement, unsigned long int Steps>
+struct subtract_numbers_constant
+{
+    static constexpr checked_result<T> result = subtract_numbers_checked<T>(Start, Decrement, Steps);
+    static_assert(result.error != numeric_error::overflow, "subtract_numbers_constant: Numeric overflow has occured!");
+    static_assert(result.error != numeric_error::underflow, "subtract_numbers_constant: Numeric underflow has occured!");
+    static constexpr T value = result.value;
+};
+
+// the kernels are checked by the compiler against the same cases the tests print
+static_assert(add_numbers<int>(0, std::numeric_limits<int>::max() / 5, 5) == std::numeric_limits<int>::max() / 5 * 5);
+static_assert(!add_numbers<int, report_policy>(0, std::numeric_limits<int>::max() / 5, 6));
+static_assert(subtract_numbers<unsigned char, saturate_policy>(255, 51, 6) == 0);
+// only wrap_policy finishes a failed real number sum, which here would leave the range of float
+static_assert(add_numbers<float, report_policy>(0, std::numeric_limits<float>::max() / 5, 6).error == numeric_error::overflow);
+static_assert(add_numbers<float, saturate_policy>(0, -std::numeric_limits<float>::max() / 5, 6) == std::numeric_limits<float>::lowest());
+static_assert(subtract_numbers<double, saturate_policy>(0, std::numeric_limits<double>::max() / 5, 6) == std::numeric_limits<double>::lowest());
+// a real number sum that only goes below zero is still in range
+static_assert(subtract_numbers<double, saturate_policy>(1.0, 0.5, 3) == -0.5);
+static_assert(add_numbers<double, report_policy>(0.0, -1.0, 1).error == numeric_error::none);
+static_assert(add_numbers<float, report_policy>(0.25f, -0.5f, 3).value == -1.25f);
+static_assert(subtract_numbers<float, saturate_policy>(0.0f, 2.0f, 4) == -8.0f);
+static_assert(add_numbers_constant<short int, 0, 100, 300>::value == 30000);
+static_assert(add_numbers<wide_int128>(0, std::numeric_limits<wide_int128>::max() / 5, 5) == std::numeric_limits<wide_int128>::max() / 5 * 5);
+static_assert(!add_numbers<wide_uint256, report_policy>(std::numeric_limits<wide_uint256>::max() - 1, 1, 2));
+
+/*
+   Step queries. Instead of finding out about an overflow by failing, a caller can
+   ask up front how many steps stay in range and run that many without checks,
+   checking once per chunk. Each query is integral_headroom_steps, the division
+   the portable kernel makes, so it is O(1) and agrees with add_numbers and
+   subtract_numbers exactly. A step count that does not fit in unsigned long int
+   is reported as its maximum, which means any number of steps is safe.
+*/
+
+/// <summary>
+/// How many steps of magnitude can be taken from start towards one limit of T
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="magnitude">The absolute size of each step</param>
+/// <param name="ascending">true to move towards MAX, false to move towards MIN</param>
+/// <returns>The largest safe step count, clamped to the range of unsigned long int</returns>
+template <typename T>
+constexpr unsigned long int integral_steps_in_range(T const& start, std::uintmax_t const& magnitude, bool const& ascending)
+{
+    constexpr unsigned long int unlimited = std::numeric_limits<unsigned long int>::max();
+
+    if (magnitude == 0)
+    {
+        return unlimited;
+    }
+    return static_cast<unsigned long int>(std::min<std::uintmax_t>(integral_headroom_steps<T>(start, magnitude, ascending), unlimited));
+}
+
+/// <summary>
+/// How many steps add_numbers(start, increment, steps) can take before it overflows.
+/// An increment that is not positive never overflows.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <returns>The largest step count that does not overflow</returns>
+template <typename T>
+constexpr unsigned long int steps_until_overflow(T const& start, T const& increment)
+{
+    static_assert(std::is_integral<T>::value, "steps_until_overflow only supports integral types");
+    return increment > 0 ? integral_steps_in_range<T>(start, integral_magnitude(increment), true) : std::numeric_limits<unsigned long int>::max();
+}
+
+/// <summary>
+/// How many steps subtract_numbers(start, decrement, steps) can take before it underflows.
+/// A decrement that is not positive never underflows.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="decrement">How much to subtract each step</param>
+/// <returns>The largest step count that does not underflow</returns>
+template <typename T>
+constexpr unsigned long int steps_until_underflow(T const& start, T const& decrement)
+{
+    static_assert(std::is_integral<T>::value, "steps_until_underflow only supports integral types");
+    return decrement > 0 ? integral_steps_in_range<T>(start, integral_magnitude(decrement), false) : std::numeric_limits<unsigned long int>::max();
+}
+
+/// <summary>
+/// How many steps add_numbers(start, increment, steps) can take before it leaves
+/// the range of T in either direction, for increments of any sign
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <returns>The largest step count that stays in range</returns>
+template <typename T>
+constexpr unsigned long int steps_in_range(T const& start, T const& increment)
+{
+    static_assert(std::is_integral<T>::value, "steps_in_range only supports integral types");
+    return integral_steps_in_range<T>(start, integral_magnitude(increment), !(increment < 0));
+}
+
+static_assert(steps_until_overflow<int>(0, std::numeric_limits<int>::max() / 5) == 5);
+static_assert(steps_until_overflow<signed char>(-128, 1) == 255);
+static_assert(steps_until_underflow<unsigned char>(255, 51) == 5);
+static_assert(steps_until_underflow<int>(0, -1) == std::numeric_limits<unsigned long int>::max());
+static_assert(steps_in_range<short int>(0, std::numeric_limits<short int>::min()) == 1);
+static_assert(add_numbers_checked<int>(7, 3, steps_until_overflow<int>(7, 3)) && !add_numbers_checked<int>(7, 3, steps_until_overflow<int>(7, 3) + 1));
+
+/*
+   Multiply, divide and shift. These follow the shape of add_numbers: the operation
+   is applied to start once per step, the first step that leaves the range of T is
+   reported, and the policy decides what the caller gets. They are meant for
+   allocation size computations such as multiply_numbers<std::size_t>(count, size, 1),
+   so each step is a single widening multiply or builtin check, and steps past the
+   point where the value can no longer change are not iterated.
+*/
+
+/// <summary>
+/// Checked a * b using a multiply twice the width of T. Types up to 32 bits fit
+/// the product of their magnitudes in 64 bits, 64 bit types use multiply_limbs.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <returns>a * b, or the wrapped product and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> integral_multiply_portable(T const& a, T const& b)
+{
+    using narrow = std::make_unsigned_t<T>;
+
+    const bool negative = (a < 0) != (b < 0);
+    std::uint64_t high = 0;
+    std::uint64_t low;
+
+    if constexpr (sizeof(T) <= 4)
+    {
+        low = std::uint64_t(integral_magnitude(a)) * std::uint64_t(integral_magnitude(b));
+    }
+    else
+    {
+        low = multiply_limbs(integral_magnitude(a), integral_magnitude(b), high);
+    }
+
+    // the largest magnitude T can hold on the side of zero the product is on
+    const std::uint64_t limit = negative ? integral_magnitude(std::numeric_limits<T>::min()) : std::uint64_t(std::numeric_limits<T>::max());
+    const T result = static_cast<T>(negative ? narrow(narrow(0) - narrow(low)) : narrow(low));
+
+    if (high != 0 || low > limit)
+    {
+        return { result, negative ? numeric_error::underflow : numeric_error::overflow };
+    }
+    return { result, numeric_error::none };
+}
+
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+/// <summary>
+/// Same contract as integral_multiply_portable using the compiler's checked multiply
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <returns>a * b, or the wrapped product and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> integral_multiply_builtin(T const& a, T const& b)
+{
+    T result;
+    if (__builtin_mul_overflow(a, b, &result))
+    {
+        return { result, (a < 0) != (b < 0) ? numeric_error::underflow : numeric_error::overflow };
+    }
+    return { result, numeric_error::none };
+}
+#endif
+
+/// <summary>
+/// Dispatches to the checked multiply backend selected by NUMERIC_OVERFLOW_USE_BUILTINS.
+/// </summary>
+template <typename T>
+constexpr checked_result<T> integral_multiply(T const& a, T const& b)
+{
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    return integral_multiply_builtin<T>(a, b);
+#else
+    return integral_multiply_portable<T>(a, b);
+#endif
+}
+
+/// <summary>
+/// Non-throwing version of multiply_numbers:
+///   start * (factor ^ steps)
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="factor">What to multiply by each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start * (factor ^ steps), or the wrapped result and the limit crossed by the first failing step</returns>
+template <typename T>
+constexpr checked_result<T> multiply_numbers_checked(T const& start, T const& factor, unsigned long int const& steps)
+{
+    static_assert(std::is_integral<T>::value, "multiply_numbers only supports integral types");
+    using narrow = std::make_unsigned_t<T>;
+
+    // a single step, as in count * size, is one checked multiply
+    if (steps == 1)
+    {
+        return integral_multiply<T>(start, factor);
+    }
+    if (steps == 0 || start == 0 || factor == 1)
+    {
+        return { start, numeric_error::none };
+    }
+    if (factor == 0)
+    {
+        return { T(0), numeric_error::none };
+    }
+
+    // a factor of -1 only flips the sign, and only MIN of a signed type can not be flipped
+    if constexpr (std::is_signed<T>::value)
+    {
+        if (factor == -1)
+        {
+            const T flipped = static_cast<T>(narrow(0) - narrow(start));
+            const T result = steps % 2 == 1 ? flipped : start;
+            return { result, start == std::numeric_limits<T>::min() ? numeric_error::overflow : numeric_error::none };
+        }
+    }
+
+    // the magnitude at least doubles every step, so this fails within digits steps
+    T result = start;
+    unsigned long int i = 0;
+    for (; i < steps; ++i)
+    {
+        const checked_result<T> next = integral_multiply<T>(result, factor);
+        result = next.value;
+        if (!next)
+        {
+            // finish the remaining steps as a wrapped power for wrap_policy
+            std::uintmax_t wrapped = std::uintmax_t(narrow(result));
+            std::uintmax_t base = std::uintmax_t(narrow(factor));
+            for (unsigned long int exponent = steps - i - 1; exponent != 0; exponent >>= 1)
+            {
+                if (exponent & 1)
+                {
+                    wrapped = std::uintmax_t(narrow(wrapped * base));
+                }
+                base = std::uintmax_t(narrow(base * base));
+            }
+            return { static_cast<T>(narrow(wrapped)), next.error };
+        }
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start * (factor ^ steps)
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="factor">What to multiply by each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>start * (factor ^ steps)</returns>
+template <typename T, typename Policy = throw_policy>
+constexpr auto multiply_numbers(T const& start, T const& factor, unsigned long int const& steps)
+{
+    return Policy::resolve(multiply_numbers_checked<T>(start, factor, steps));
+}
+
+/// <summary>
+/// Non-throwing version of divide_numbers. Each step truncates towards zero like
+/// the built-in operator. Dividing by zero is reported instead of trapping, and so
+/// is MIN / -1, whose true result is one past MAX and which traps on x86.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="divisor">What to divide by each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start / (divisor ^ steps), or start (MIN for MIN / -1) and why it has no valid result</returns>
+template <typename T>
+constexpr checked_result<T> divide_numbers_checked(T const& start, T const& divisor, unsigned long int const& steps)
+{
+    static_assert(std::is_integral<T>::value, "divide_numbers only supports integral types");
+    using narrow = std::make_unsigned_t<T>;
+
+    if (steps == 0 || divisor == 1)
+    {
+        return { start, numeric_error::none };
+    }
+    if (divisor == 0)
+    {
+        return { start, numeric_error::division_by_zero };
+    }
+
+    if constexpr (std::is_signed<T>::value)
+    {
+        if (divisor == -1)
+        {
+            // two's complement wraps -MIN back to MIN
+            const T flipped = static_cast<T>(narrow(0) - narrow(start));
+            const T result = steps % 2 == 1 ? flipped : start;
+            return { result, start == std::numeric_limits<T>::min() ? numeric_error::overflow : numeric_error::none };
+        }
+    }
+
+    // the magnitude at least halves every step, so this reaches zero within digits steps
+    T result = start;
+    for (unsigned long int i = 0; i < steps && result != 0; ++i)
+    {
+        result = static_cast<T>(result / divisor);
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start / (divisor ^ steps)
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="divisor">What to divide by each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">What to do when there is no valid result, throw_policy by default</typeparam>
+/// <returns>start / (divisor ^ steps)</returns>
+template <typename T, typename Policy = throw_policy>
+constexpr auto divide_numbers(T const& start, T const& divisor, unsigned long int const& steps)
+{
+    return Policy::resolve(divide_numbers_checked<T>(start, divisor, steps));
+}
+
+/// <summary>
+/// The total shift of shift * steps, or the width of T when it is at least that,
+/// which is where every shift has the same result
+/// </summary>
+template <typename T>
+constexpr unsigned int total_shift(unsigned int const& shift, unsigned long int const& steps)
+{
+    constexpr unsigned int width = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+    if (shift >= width || steps >= width)
+    {
+        return shift == 0 || steps == 0 ? 0 : width;
+    }
+    return std::min<unsigned int>(shift * static_cast<unsigned int>(steps), width);
+}
+
+/// <summary>
+/// Non-throwing version of shift_left_numbers:
+///   start * (2 ^ (shift * steps))
+/// A shift of the width of T or more is defined here, it leaves 0.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="shift">How many bits to shift each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start shifted left, or the wrapped result and the limit that was crossed</returns>
+template <typename T>
+constexpr checked_result<T> shift_left_numbers_checked(T const& start, unsigned int const& shift, unsigned long int const& steps)
+{
+    static_assert(std::is_integral<T>::value, "shift_left_numbers only supports integral types");
+    using narrow = std::make_unsigned_t<T>;
+    constexpr unsigned int width = std::numeric_limits<narrow>::digits;
+
+    const unsigned int total = total_shift<T>(shift, steps);
+    if (total == 0 || start == 0)
+    {
+        return { start, numeric_error::none };
+    }
+
+    const T result = total >= width ? T(0) : static_cast<T>(narrow(std::uintmax_t(narrow(start)) << total));
+
+    // the value fits when it is within the limits shifted right by the same amount
+    const bool out_of_range = total >= width
+        || start > (std::numeric_limits<T>::max() >> total)
+        || start < (std::numeric_limits<T>::min() >> total);
+
+    if (out_of_range)
+    {
+        return { result, start < 0 ? numeric_error::underflow : numeric_error::overflow };
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start * (2 ^ (shift * steps))
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="shift">How many bits to shift each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>start shifted left by shift * steps bits</returns>
+template <typename T, typename Policy = throw_policy>
+constexpr auto shift_left_numbers(T const& start, unsigned int const& shift, unsigned long int const& steps)
+{
+    return Policy::resolve(shift_left_numbers_checked<T>(start, shift, steps));
+}
+
+/// <summary>
+/// Non-throwing version of shift_right_numbers. A right shift can not leave the
+/// range of T; the check is that a shift of the width of T or more, which is
+/// undefined for the built-in operator, leaves 0 (or -1 for a negative start).
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="shift">How many bits to shift each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start shifted right, rounding towards negative infinity</returns>
+template <typename T>
+constexpr checked_result<T> shift_right_numbers_checked(T const& start, unsigned int const& shift, unsigned long int const& steps)
+{
+    static_assert(std::is_integral<T>::value, "shift_right_numbers only supports integral types");
+    constexpr unsigned int width = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+
+    const unsigned int total = total_shift<T>(shift, steps);
+    if (total >= width)
+    {
+        return { start < 0 ? T(-1) : T(0), numeric_error::none };
+    }
+    return { static_cast<T>(start >> total), numeric_error::none };
+}
+
+/// <summary>
+/// Template function to abstract away the logic of:
+///   start / (2 ^ (shift * steps))
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="shift">How many bits to shift each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Policy">Accepted for symmetry, a right shift always has a valid result</typeparam>
+/// <returns>start shifted right by shift * steps bits</returns>
+template <typename T, typename Policy = throw_policy>
+constexpr auto shift_right_numbers(T const& start, unsigned int const& shift, unsigned long int const& steps)
+{
+    return Policy::resolve(shift_right_numbers_checked<T>(start, shift, steps));
+}
+
+static_assert(multiply_numbers<std::size_t>(1000, 24, 1) == 24000);
+static_assert(!multiply_numbers<std::size_t, report_policy>(std::numeric_limits<std::size_t>::max() / 24 + 1, 24, 1));
+static_assert(multiply_numbers<short int, report_policy>(-2, 2, 15).error == numeric_error::underflow);
+static_assert(multiply_numbers<int, wrap_policy>(3, 2, 40) == 0);
+static_assert(divide_numbers<int, report_policy>(std::numeric_limits<int>::min(), -1, 1).error == numeric_error::overflow);
+static_assert(divide_numbers<int, report_policy>(7, 0, 1).error == numeric_error::division_by_zero);
+static_assert(divide_numbers<int>(-1000, 10, 2) == -10);
+static_assert(shift_left_numbers<unsigned char>(3, 3, 2) == 192);
+static_assert(!shift_left_numbers<int, report_policy>(1, 31, 1));
+static_assert(shift_right_numbers<long long>(-5, 64, 1) == -1);
+
+/*
+   Mixed-type arithmetic. add_numbers needs start and increment to share a type,
+   so mixed callers had to cast first and a cast silently truncates or changes the
+   sign. checked_add<R>(a, b) and friends take the operands as they are and check
+   the exact result against the limits of R. The strategy is chosen at compile
+   time from the widths of R, A and B: when a wider signed type holds every
+   possible result the operation is done there with no check at all, otherwise
+   the compiler's checked builtins are used, and without those the operands are
+   split into sign and magnitude.
+*/
+
+/// <summary>
+/// The operations of the checked_add family
+/// </summary>
+enum class mixed_operation
+{
+    add,
+    subtract,
+    multiply
+};
+
+/// <summary>
+/// How a mixed-type operation is evaluated, cheapest first
+/// </summary>
+enum class mixed_strategy
+{
+    promote_int64,
+    promote_int128,
+    builtin,
+    portable
+};
+
+/// <summary>
+/// Selects the cheapest safe strategy for Op on A and B. A sum needs one more value
+/// bit than the wider operand and a product needs the value bits of both operands.
+/// </summary>
+template <mixed_operation Op, typename A, typename B>
+constexpr mixed_strategy mixed_strategy_for()
+{
+    constexpr int a_digits = std::numeric_limits<A>::digits;
+    constexpr int b_digits = std::numeric_limits<B>::digits;
+    constexpr int needed = Op == mixed_operation::multiply ? a_digits + b_digits : std::max(a_digits, b_digits) + 1;
+
+    if (needed <= std::numeric_limits<std::int64_t>::digits)
+    {
+        return mixed_strategy::promote_int64;
+    }
+#if defined(__SIZEOF_INT128__)
+    if (needed <= 127)
+    {
+        return mixed_strategy::promote_int128;
+    }
+#endif
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    return mixed_strategy::builtin;
+#else
+    return mixed_strategy::portable;
+#endif
+}
+
+/// <summary>
+/// Checks a value of any integral type W against the limits of R
+/// </summary>
+/// <returns>value converted to R, or the wrapped value and the limit that was crossed</returns>
+template <typename R, typename W>
+constexpr checked_result<R> narrow_checked(W const& value)
+{
+    // two's complement conversion, so out of range values wrap like the built-in types
+    const R result = static_cast<R>(value);
+
+    // a limit of R that W can not hold can not be crossed either
+    if constexpr (std::numeric_limits<R>::digits <= std::numeric_limits<W>::digits)
+    {
+        if (value > static_cast<W>(std::numeric_limits<R>::max()))
+        {
+            return { result, numeric_error::overflow };
+        }
+    }
+    // an unsigned W can not cross the lower limit of R. Not std::is_signed, which
+    // is false for __int128 in strict standard modes.
+    constexpr bool signed_source = W(-1) < W(0);
+    if constexpr (std::is_unsigned<R>::value && signed_source)
+    {
+        if (value < 0)
+        {
+            return { result, numeric_error::underflow };
+        }
+    }
+    else if constexpr (signed_source && std::numeric_limits<R>::digits <= std::numeric_limits<W>::digits)
+    {
+        if (value < static_cast<W>(std::numeric_limits<R>::min()))
+        {
+            return { result, numeric_error::underflow };
+        }
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// A 64 bit integer of either signedness as a sign and an unsigned magnitude,
+/// which holds every value of both int64 and uint64
+/// </summary>
+struct signed_magnitude
+{
+    bool negative;
+    std::uint64_t magnitude;
+    bool carry;   // the true magnitude is magnitude + 2^64 or more
+};
+
+/// <summary>
+/// Evaluates Op exactly in sign and magnitude form and checks it against R
+/// </summary>
+/// <returns>a Op b converted to R, or the wrapped value and the limit that was crossed</returns>
+template <mixed_operation Op, typename R, typename A, typename B>
+constexpr checked_result<R> mixed_arithmetic_portable(A const& a, B const& b)
+{
+    signed_magnitude x = { a < 0, integral_magnitude(a), false };
+    signed_magnitude y = { b < 0, integral_magnitude(b), false };
+    signed_magnitude z = { false, 0, false };
+
+    if constexpr (Op == mixed_operation::subtract)
+    {
+        y.negative = !y.negative && y.magnitude != 0;
+    }
+
+    if constexpr (Op == mixed_operation::multiply)
+    {
+        std::uint64_t high = 0;
+        z.magnitude = multiply_limbs(x.magnitude, y.magnitude, high);
+        z.carry = high != 0;
+        z.negative = x.negative != y.negative;
+    }
+    else if (x.negative == y.negative)
+    {
+        z.magnitude = x.magnitude + y.magnitude;
+        z.carry = z.magnitude < x.magnitude;
+        z.negative = x.negative;
+    }
+    else
+    {
+        // opposite signs, so the larger magnitude decides the sign
+        const bool x_larger = x.magnitude >= y.magnitude;
+        z.magnitude = x_larger ? x.magnitude - y.magnitude : y.magnitude - x.magnitude;
+        z.negative = x_larger ? x.negative : y.negative;
+    }
+    z.negative = z.negative && (z.magnitude != 0 || z.carry);
+
+    // the low 64 bits are the true result modulo 2^64, so this is the wrapped value
+    const R result = static_cast<R>(z.negative ? std::uint64_t(0) - z.magnitude : z.magnitude);
+
+    const std::uint64_t limit = z.negative ? integral_magnitude(std::numeric_limits<R>::min()) : std::uint64_t(std::numeric_limits<R>::max());
+    if (z.carry || z.magnitude > limit)
+    {
+        return { result, z.negative ? numeric_error::underflow : numeric_error::overflow };
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// Evaluates Op in the signed type W, which must hold every possible result, and
+/// checks it against R
+/// </summary>
+/// <returns>a Op b converted to R, or the wrapped value and the limit that was crossed</returns>
+template <mixed_operation Op, typename R, typename W, typename A, typename B>
+constexpr checked_result<R> mixed_arithmetic_promoted(A const& a, B const& b)
+{
+    if constexpr (Op == mixed_operation::add)
+    {
+        return narrow_checked<R>(W(a) + W(b));
+    }
+    else if constexpr (Op == mixed_operation::subtract)
+    {
+        return narrow_checked<R>(W(a) - W(b));
+    }
+    else
+    {
+        return narrow_checked<R>(W(a) * W(b));
+    }
+}
+
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+/// <summary>
+/// Evaluates Op with the compiler's checked builtins, which take any mix of types
+/// </summary>
+/// <returns>a Op b converted to R, or the wrapped value and the limit that was crossed</returns>
+template <mixed_operation Op, typename R, typename A, typename B>
+constexpr checked_result<R> mixed_arithmetic_builtin(A const& a, B const& b)
+{
+    R result;
+    bool out_of_range;
+    if constexpr (Op == mixed_operation::add)
+    {
+        out_of_range = __builtin_add_overflow(a, b, &result);
+    }
+    else if constexpr (Op == mixed_operation::subtract)
+    {
+        out_of_range = __builtin_sub_overflow(a, b, &result);
+    }
+    else
+    {
+        out_of_range = __builtin_mul_overflow(a, b, &result);
+    }
+
+    // the builtins do not say which limit was crossed, so the rare failures are
+    // handed to the portable version, which also keeps the errors identical
+    if (!out_of_range)
+    {
+        return { result, numeric_error::none };
+    }
+    return mixed_arithmetic_portable<Op, R>(a, b);
+}
+#endif
+
+/// <summary>
+/// Non-throwing evaluation of a Op b for any mix of integral types, checked
+/// against the limits of R
+/// </summary>
+/// <typeparam name="Op">The operation</typeparam>
+/// <typeparam name="R">The integral type of the result</typeparam>
+/// <returns>a Op b converted to R, or the wrapped value and the limit that was crossed</returns>
+template <mixed_operation Op, typename R, typename A, typename B>
+constexpr checked_result<R> mixed_arithmetic_checked(A const& a, B const& b)
+{
+    static_assert(std::is_integral<R>::value && std::is_integral<A>::value && std::is_integral<B>::value, "the checked_add family only supports integral types");
+    static_assert(!std::is_same<R, bool>::value && !std::is_same<A, bool>::value && !std::is_same<B, bool>::value, "the checked_add family does not support bool");
+
+    constexpr mixed_strategy strategy = mixed_strategy_for<Op, A, B>();
+
+    if constexpr (strategy == mixed_strategy::promote_int64)
+    {
+        return mixed_arithmetic_promoted<Op, R, std::int64_t>(a, b);
+    }
+#if defined(__SIZEOF_INT128__)
+    else if constexpr (strategy == mixed_strategy::promote_int128)
+    {
+        return mixed_arithmetic_promoted<Op, R, __int128>(a, b);
+    }
+#endif
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    else if constexpr (strategy == mixed_strategy::builtin)
+    {
+        return mixed_arithmetic_builtin<Op, R>(a, b);
+    }
+#endif
+    else
+    {
+        return mixed_arithmetic_portable<Op, R>(a, b);
+    }
+}
+
+/// <summary>
+/// a + b for any mix of integral types, checked against the limits of R
+/// </summary>
+/// <typeparam name="R">The integral type of the result</typeparam>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>a + b as R</returns>
+template <typename R, typename Policy = throw_policy, typename A, typename B>
+constexpr auto checked_add(A const& a, B const& b)
+{
+    return Policy::resolve(mixed_arithmetic_checked<mixed_operation::add, R>(a, b));
+}
+
+/// <summary>
+/// a - b for any mix of integral types, checked against the limits of R
+/// </summary>
+/// <typeparam name="R">The integral type of the result</typeparam>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>a - b as R</returns>
+template <typename R, typename Policy = throw_policy, typename A, typename B>
+constexpr auto checked_subtract(A const& a, B const& b)
+{
+    return Policy::resolve(mixed_arithmetic_checked<mixed_operation::subtract, R>(a, b));
+}
+
+/// <summary>
+/// a * b for any mix of integral types, checked against the limits of R
+/// </summary>
+/// <typeparam name="R">The integral type of the result</typeparam>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+/// <returns>a * b as R</returns>
+template <typename R, typename Policy = throw_policy, typename A, typename B>
+constexpr auto checked_multiply(A const& a, B const& b)
+{
+    return Policy::resolve(mixed_arithmetic_checked<mixed_operation::multiply, R>(a, b));
+}
+
+static_assert(mixed_strategy_for<mixed_operation::add, int, unsigned int>() == mixed_strategy::promote_int64);
+static_assert(checked_add<unsigned int>(-1, 2u) == 1u);
+static_assert(checked_add<int, report_policy>(-1, 0u).value == -1);
+static_assert(checked_add<unsigned int, report_policy>(-2, 1u).error == numeric_error::underflow);
+static_assert(checked_subtract<unsigned char, report_policy>(0u, 1).error == numeric_error::underflow);
+static_assert(checked_add<long long>(std::numeric_limits<unsigned long long>::max(), std::numeric_limits<long long>::min()) == std::numeric_limits<long long>::max());
+static_assert(checked_multiply<unsigned long long, report_policy>(-1ll, 1ull).error == numeric_error::underflow);
+static_assert(checked_multiply<std::size_t>(1000u, std::uint64_t(24)) == 24000);
+static_assert(mixed_arithmetic_portable<mixed_operation::add, long long>(std::numeric_limits<unsigned long long>::max(), std::numeric_limits<long long>::min()).value == std::numeric_limits<long long>::max());
+
+/*
+   safe_int wraps an integer so the ordinary operators run the checks above:
+       safe_int<std::size_t> bytes = count;
+       bytes *= size;   // throws std::overflow_error instead of wrapping
+   Operands of another integral type go through checked_add and friends as they
+   are, so safe_int<unsigned char>(0) + 256 overflows rather than adding 0, and
+   converting one to a safe_int is explicit and checked.
+   With unchecked_policy the operators are plain wrapping arithmetic and no check
+   is compiled in, so the same code can be built checked for debug and canary
+   builds and unchecked for production, and benchmark_safe_int measures the
+   difference between the two.
+*/
+
+/// <summary>
+/// The operand types safe_int takes besides itself: any integral type but bool
+/// </summary>
+template <typename U>
+struct is_safe_int_operand : std::bool_constant<std::is_integral<U>::value && !std::is_same<U, bool>::value> {};
+
+/// <summary>
+/// An integer whose operators check for overflow and underflow and resolve the
+/// failures with Policy, or do not check at all with unchecked_policy
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <typeparam name="Policy">A policy that resolves to a value, see safe_int_default_policy</typeparam>
+template <typename T, typename Policy = safe_int_default_policy>
+class safe_int
+{
+public:
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "safe_int only supports integral types");
+    static_assert(std::is_same<decltype(Policy::resolve(checked_result<T>{})), T>::value, "safe_int needs a policy that resolves to a value");
+
+    constexpr safe_int() : number(0) {}
+    constexpr safe_int(T const& value) : number(value) {}
+
+    /// <summary>
+    /// Converts another integral type, resolving a value that T can not hold with Policy
+    /// </summary>
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value && !std::is_same<U, T>::value>>
+    explicit constexpr safe_int(U const& value) : number(Policy::resolve(narrow_checked<T>(value))) {}
+
+    constexpr T value() const
+    {
+        return number;
+    }
+
+    explicit constexpr operator T() const
+    {
+        return number;
+    }
+
+    constexpr safe_int& operator+=(safe_int const& other)
+    {
+        return *this += other.number;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    constexpr safe_int& operator+=(U const& other)
+    {
+        if constexpr (is_unchecked_policy<Policy>::value)
+        {
+            number = static_cast<T>(wrapping(number) + wrapping(static_cast<T>(other)));
+        }
+        else
+        {
+            number = checked_add<T, Policy>(number, other);
+        }
+        return *this;
+    }
+
+    constexpr safe_int& operator-=(safe_int const& other)
+    {
+        return *this -= other.number;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    constexpr safe_int& operator-=(U const& other)
+    {
+        if constexpr (is_unchecked_policy<Policy>::value)
+        {
+            number = static_cast<T>(wrapping(number) - wrapping(static_cast<T>(other)));
+        }
+        else
+        {
+            number = checked_subtract<T, Policy>(number, other);
+        }
+        return *this;
+    }
+
+    constexpr safe_int& operator*=(safe_int const& other)
+    {
+        if constexpr (is_unchecked_policy<Policy>::value)
+        {
+            number = static_cast<T>(wrapping(number) * wrapping(other.number));
+        }
+        else
+        {
+            number = Policy::resolve(integral_multiply<T>(number, other.number));
+        }
+        return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    constexpr safe_int& operator*=(U const& other)
+    {
+        if constexpr (is_unchecked_policy<Policy>::value || std::is_same<U, T>::value)
+        {
+            return *this *= safe_int(static_cast<T>(other));
+        }
+        else
+        {
+            number = checked_multiply<T, Policy>(number, other);
+            return *this;
+        }
+    }
+
+    /// <summary>
+    /// Division is checked with every policy: dividing by zero or MIN / -1 is
+    /// undefined for the built-in operator, so there is nothing cheaper to fall back to
+    /// </summary>
+    constexpr safe_int& operator/=(safe_int const& other)
+    {
+        number = Policy::resolve(divide_numbers_checked<T>(number, other.number, 1));
+        return *this;
+    }
+
+    /// <summary>
+    /// The divisor is converted to T first, with the same check as the constructor
+    /// </summary>
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    constexpr safe_int& operator/=(U const& other)
+    {
+        return *this /= safe_int(other);
+    }
+
+    constexpr safe_int& operator++()
+    {
+        return *this += T(1);
+    }
+
+    constexpr safe_int& operator--()
+    {
+        return *this -= T(1);
+    }
+
+    constexpr safe_int operator++(int)
+    {
+        const safe_int before = *this;
+        *this += T(1);
+        return before;
+    }
+
+    constexpr safe_int operator--(int)
+    {
+        const safe_int before = *this;
+        *this -= T(1);
+        return before;
+    }
+
+    constexpr safe_int operator-() const
+    {
+        return safe_int(T(0)) -= *this;
+    }
+
+    friend constexpr safe_int operator+(safe_int left, safe_int const& right)
+    {
+        return left += right;
+    }
+
+    friend constexpr safe_int operator-(safe_int left, safe_int const& right)
+    {
+        return left -= right;
+    }
+
+    friend constexpr safe_int operator*(safe_int left, safe_int const& right)
+    {
+        return left *= right;
+    }
+
+    friend constexpr safe_int operator/(safe_int left, safe_int const& right)
+    {
+        return left /= right;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator+(safe_int left, U const& right)
+    {
+        return left += right;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator-(safe_int left, U const& right)
+    {
+        return left -= right;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator*(safe_int left, U const& right)
+    {
+        return left *= right;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator/(safe_int left, U const& right)
+    {
+        return left /= right;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator+(U const& left, safe_int const& right)
+    {
+        return safe_int(right) += left;
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator-(U const& left, safe_int const& right)
+    {
+        if constexpr (is_unchecked_policy<Policy>::value)
+        {
+            return safe_int(static_cast<T>(left)) -= right;
+        }
+        else
+        {
+            return safe_int(checked_subtract<T, Policy>(left, right.number));
+        }
+    }
+
+    template <typename U, typename = std::enable_if_t<is_safe_int_operand<U>::value>>
+    friend constexpr safe_int operator*(U const& left, safe_int const& right)
+    {
+        return safe_int(right) *= left;
+    }
+
+    friend constexpr bool operator==(safe_int const& left, safe_int const& right) = default;
+    friend constexpr auto operator<=>(safe_int const& left, safe_int const& right) = default;
+
+    friend std::ostream& operator<<(std::ostream& out, safe_int const& value)
+    {
+        // promote so char types print as numbers
+        return out << +value.number;
+    }
+
+private:
+    // unsigned and at least as wide as unsigned int, so the small types are not
+    // promoted to int, where the wrapping arithmetic would be undefined
+    using wrapping = decltype(std::make_unsigned_t<T>(0) + 0u);
+
+    T number;
+};
+
+static_assert((safe_int<int>(20) + 22).value() == 42);
+static_assert((safe_int<unsigned char, saturate_policy>(250) + 10).value() == 255);
+static_assert((safe_int<short int, saturate_policy>(-30000) * 2).value() == std::numeric_limits<short int>::min());
+static_assert((safe_int<int, unchecked_policy>(std::numeric_limits<int>::max()) + 1).value() == std::numeric_limits<int>::min());
+static_assert(-safe_int<int, saturate_policy>(std::numeric_limits<int>::min()) == std::numeric_limits<int>::max());
+static_assert(safe_int<long long>(-7) / 2 < safe_int<long long>(0));
+static_assert((safe_int<unsigned char, saturate_policy>(0) + 256).value() == 255);
+static_assert((safe_int<unsigned int>(5) - (-1)).value() == 6);
+static_assert((-1 + safe_int<unsigned int>(3)).value() == 2);
+static_assert((1 - safe_int<int, saturate_policy>(std::numeric_limits<int>::min())).value() == std::numeric_limits<int>::max());
+static_assert((safe_int<unsigned char, saturate_policy>(3) * -1).value() == 0);
+static_assert(safe_int<unsigned char, saturate_policy>(300).value() == 255);
+static_assert(safe_int<int, saturate_policy>(std::numeric_limits<unsigned long long>::max()).value() == std::numeric_limits<int>::max());
+static_assert((safe_int<unsigned char, unchecked_policy>(0) + 256).value() == 0);
+
+/*
+   Floating-point mode. The limit checks in add_numbers_checked never fire for real
+   numbers because max - increment rounds back to max, and an increment that is
+   too small to change the sum is silently dropped. This mode lets the hardware
+   detect both: the steps run as a plain branch-free loop in blocks, and after
+   each block the FE_OVERFLOW flag says whether the sum reached infinity and a
+   single compare says whether the increment is being absorbed. The compilers
+   only promise to keep the flags meaningful with floating-point environment
+   access on, so it is enabled for this section: fenv_access for MSVC and
+   FENV_ACCESS for Clang. GCC ignores the pragma; its default -ftrapping-math
+   keeps the additions in front of the flag test in practice, and because every
+   overflow in the default rounding mode ends in an infinity the block result is
+   tested for that as well, which needs no flags at all.
+*/
+#if defined(_MSC_VER)
+#pragma fenv_access (on)
+#elif defined(__clang__)
+#pragma STDC FENV_ACCESS ON
+#endif
+
+/// <summary>
+/// The result of start + (increment * steps) when start or increment is not finite.
+/// An infinity is out of range on its side; a NaN input, or infinities of opposite
+/// signs, leave no meaningful value and are reported as precision_loss.
+/// </summary>
+template <typename T>
+checked_result<T> non_finite_sum(T const& start, T const& increment, unsigned long int const& steps)
+{
+    const T result = steps == 0 ? start : start + increment;
+    if (std::isnan(result))
+    {
+        return { result, numeric_error::precision_loss };
+    }
+    if (std::isinf(result))
+    {
+        return { result, result < 0 ? numeric_error::underflow : numeric_error::overflow };
+    }
+    return { result, numeric_error::none };
+}
+
+/// <summary>
+/// Non-throwing floating-point version of add_numbers:
+///   start + (increment * steps)
+/// Overflow to +infinity is reported as overflow and to -infinity as underflow.
+/// Once an increment is absorbed (result + increment == result) the sum can never
+/// change again, so the rest of the steps are skipped and precision_loss is reported.
+/// Absorption that starts inside a block is caught at the end of it, because the
+/// sum only grows away from zero from then on and stays absorbed.
+/// An infinite start or increment is already out of range and is reported the
+/// same way as an overflow to it, see non_finite_sum.
+/// The caller's floating-point exception flags are left as they were.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start + (increment * steps), or the value reached and why it is wrong</returns>
+template <typename T>
+checked_result<T> add_numbers_float_checked(T const& start, T const& increment, unsigned long int const& steps)
+{
+    static_assert(std::is_floating_point<T>::value, "add_numbers_float_checked is for real numbers");
+
+    // inf + inc == inf raises no flag and looks like an absorbed increment, so non-finite inputs are classified here
+    if (!std::isfinite(start) || !std::isfinite(increment))
+    {
+        return non_finite_sum<T>(start, increment, steps);
+    }
+
+    // large enough that the block boundary test is lost in the noise of the loop
+    const unsigned long int block_size = 4096;
+
+    std::fexcept_t caller_flags;
+    std::fegetexceptflag(&caller_flags, FE_OVERFLOW);
+
+    T result = start;
+    numeric_error error = numeric_error::none;
+    unsigned long int remaining = steps;
+
+    while (remaining > 0)
+    {
+        const unsigned long int block = std::min(remaining, block_size);
+        std::feclearexcept(FE_OVERFLOW);
+
+        for (unsigned long int i = 1; i < block; ++i)
+        {
+            result += increment;
+        }
+        const T before = result;
+        result += increment;
+        remaining -= block;
+
+        if (std::fetestexcept(FE_OVERFLOW) || std::isinf(result))
+        {
+            error = result < 0 ? numeric_error::underflow : numeric_error::overflow;
+            break;
+        }
+
+        // the last step was dropped, or the next one will be
+        if (increment != 0 && (result == before || (remaining > 0 && result + increment == result)))
+        {
+            error = numeric_error::precision_loss;
+            break;
+        }
+    }
+
+    std::fesetexceptflag(&caller_flags, FE_OVERFLOW);
+    return { result, error };
+}
+
+/// <summary>
+/// Non-throwing floating-point version of subtract_numbers, see add_numbers_float_checked.
+/// Negating a real number is exact, so this is addition of -decrement.
+/// </summary>
+template <typename T>
+checked_result<T> subtract_numbers_float_checked(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    return add_numbers_float_checked<T>(start, -decrement, steps);
+}
+
+/// <summary>
+/// Floating-point version of add_numbers that catches overflow to infinity and
+/// absorbed increments, see add_numbers_float_checked.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <typeparam name="Policy">What to do when the result is wrong, throw_policy by default</typeparam>
+template <typename T, typename Policy = throw_policy>
+auto add_numbers_float(T const& start, T const& increment, unsigned long int const& steps)
+{
+    return Policy::resolve(add_numbers_float_checked<T>(start, increment, steps));
+}
+
+/// <summary>
+/// Floating-point version of subtract_numbers, see add_numbers_float_checked.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <typeparam name="Policy">What to do when the result is wrong, throw_policy by default</typeparam>
+template <typename T, typename Policy = throw_policy>
+auto subtract_numbers_float(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    return Policy::resolve(subtract_numbers_float_checked<T>(start, decrement, steps));
+}
+
+#if defined(_MSC_VER)
+#pragma fenv_access (off)
+#elif defined(__clang__)
+#pragma STDC FENV_ACCESS OFF
+#endif
+
+/*
+   Chunked mode. add_numbers_checked tests both limits before every step of a real
+   number sum. Far from the limits those tests can not fire, so this mode works out
+   up front how many steps are certainly safe, runs that many as a plain loop with
+   no tests, and only checks again at the block boundary. Near a limit the blocks
+   shrink to nothing and the remaining steps fall back to the per-step loop, so
+   the value and the error are always identical to add_numbers. Integers are
+   already evaluated in closed form and are passed straight through.
+*/
+
+/// <summary>
+/// How many steps of increment certainly pass the per-step limit test of
+/// add_numbers_checked when starting from result. Each rounded step can exceed
+/// the exact sum by at most one rounding of the largest value on the way, and the
+/// answer is scaled down so the rounding of this estimate itself can not make it
+/// too large.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <param name="result">The value reached so far</param>
+/// <param name="increment">How much to add each step, finite and not 0</param>
+/// <param name="remaining">The most steps that are needed</param>
+/// <returns>A safe block size no larger than remaining, 0 near the limit</returns>
+template <typename T>
+unsigned long int safe_block_steps(T const& result, T const& increment, unsigned long int const& remaining)
+{
+    constexpr T unit = std::numeric_limits<T>::epsilon();
+
+    // the same limits the per-step test compares against
+    const T limit = increment > 0 ? std::numeric_limits<T>::max() - increment : std::numeric_limits<T>::lowest() - increment;
+    // from one side of zero to the far limit the distance can round to infinity,
+    // and max is still a safe underestimate of it
+    const T headroom = std::min(increment > 0 ? limit - result : result - limit, std::numeric_limits<T>::max());
+    if (!(headroom > 0))
+    {
+        return 0;
+    }
+
+    // every value on the way lies between result and limit
+    const T largest = std::max(std::abs(result), std::abs(limit)) + std::abs(increment);
+    const T stride = std::abs(increment) + unit * largest;
+
+    const T block = std::floor(headroom / stride * (1 - 4 * unit));
+    if (!(block >= 1))
+    {
+        return 0;
+    }
+    return block < T(remaining) ? static_cast<unsigned long int>(block) : remaining;
+}
+
+/// <summary>
+/// Non-throwing chunked version of add_numbers, identical to add_numbers_checked
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Unchecked">false to stop at the first failure, see add_numbers_checked</typeparam>
+/// <returns>start + (increment * steps), or the unchecked result and why it is out of range</returns>
+template <typename T, bool Unchecked = true>
+checked_result<T> add_numbers_chunked_checked(T const& start, T const& increment, unsigned long int const& steps)
+{
+    if constexpr (!std::is_floating_point<T>::value)
+    {
+        return add_numbers_checked<T>(start, increment, steps);
+    }
+    else
+    {
+        // infinities, NaN and 0 are left to the per-step loop, which already handles them
+        if (!std::isfinite(start) || !std::isfinite(increment) || increment == 0)
+        {
+            return add_numbers_checked<T, Unchecked>(start, increment, steps);
+        }
+
+        T result = start;
+        unsigned long int done = 0;
+        while (done < steps)
+        {
+            const unsigned long int block = safe_block_steps<T>(result, increment, steps - done);
+            if (block == 0)
+            {
+                break;
+            }
+
+            // no test can fire inside the block, so it is a plain dependent add
+            for (unsigned long int i = 0; i < block; ++i)
+            {
+                result += increment;
+            }
+            done += block;
+        }
+
+        // whatever is left is close to a limit, finish with the per-step tests
+        return add_numbers_checked<T, Unchecked>(result, increment, steps - done);
+    }
+}
+
+/// <summary>
+/// Non-throwing chunked version of subtract_numbers, identical to subtract_numbers_checked.
+/// Negating a real number is exact, so this is the chunked add of -decrement.
+/// </summary>
+/// <typeparam name="T">A type that with basic math functions</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="decrement">How much to subtract each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <typeparam name="Unchecked">false to stop at the first failure, see add_numbers_checked</typeparam>
+/// <returns>start - (decrement * steps), or the unchecked result and why it is out of range</returns>
+template <typename T, bool Unchecked = true>
+checked_result<T> subtract_numbers_chunked_checked(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    if constexpr (!std::is_floating_point<T>::value)
+    {
+        return subtract_numbers_checked<T>(start, decrement, steps);
+    }
+    else
+    {
+        return add_numbers_chunked_checked<T, Unchecked>(start, -decrement, steps);
+    }
+}
+
+/// <summary>
+/// Chunked version of add_numbers, see add_numbers_chunked_checked.
+/// </summary>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+template <typename T, typename Policy = throw_policy>
+auto add_numbers_chunked(T const& start, T const& increment, unsigned long int const& steps)
+{
+    return Policy::resolve(add_numbers_chunked_checked<T, policy_uses_unchecked_value<Policy>::value>(start, increment, steps));
+}
+
+/// <summary>
+/// Chunked version of subtract_numbers, see subtract_numbers_chunked_checked.
+/// </summary>
+/// <typeparam name="Policy">What to do when the result is out of range, throw_policy by default</typeparam>
+template <typename T, typename Policy = throw_policy>
+auto subtract_numbers_chunked(T const& start, T const& decrement, unsigned long int const& steps)
+{
+    return Policy::resolve(subtract_numbers_chunked_checked<T, policy_uses_unchecked_value<Policy>::value>(start, decrement, steps));
+}
+
+/*
+   Accuracy modes for real numbers. Adding the same increment steps times one step
+   at a time lets the rounding error grow with steps, and the strict ordering of
+   real number addition keeps the compiler from spreading the loop over SIMD
+   lanes. Both modes below give the compiler independent accumulators to work
+   with instead. Neither survives fast-math style reassociation (/fp:fast,
+   -ffast-math), which would optimize the compensation away.
+*/
+
+/// <summary>
+/// Reports a real number sum of start + (increment * steps) that is no longer
+/// finite as overflow / underflow. Once a partial sum reaches infinity the
+/// compensation terms become NaN, so the sign of the sum can not be trusted. With
+/// finite inputs a sum can only leave the range on the side the increment moves
+/// towards, so the increment decides, and the value is that side's infinity.
+/// </summary>
+template <typename T>
+checked_result<T> check_real_sum(T const& sum, T const& start, T const& increment, unsigned long int const& steps)
+{
+    if (std::isfinite(sum))
+    {
+        return { sum, numeric_error::none };
+    }
+    if (!std::isfinite(start) || !std::isfinite(increment))
+    {
+        return non_finite_sum<T>(start, increment, steps);
+    }
+    const T infinity = std::numeric_limits<T>::infinity();
+    return increment < 0 ? checked_result<T>{ -infinity, numeric_error::underflow } : checked_result<T>{ infinity, numeric_error::overflow };
+}
+
+/// <summary>
+/// One step of Neumaier's compensated summation: sum += value, with the rounding
+/// error of the addition collected in compensation. Written with a select rather
+/// than a branch so the lanes of add_numbers_compensated can be vectorized.
+/// </summary>
+template <typename T>
+void neumaier_add(T& sum, T& compensation, T const& value)
+{
+    const T total = sum + value;
+    compensation += std::abs(sum) >= std::abs(value) ? (sum - total) + value : (value - total) + sum;
+    sum = total;
+}
+
+/// <summary>
+/// Compensated (Neumaier) version of add_numbers for real numbers:
+///   start + (increment * steps)
+/// The steps are spread round-robin over eight independent compensated lanes,
+/// which are combined with the same compensation at the end, so the error no
+/// longer grows with steps and the lane loop can use SIMD.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <typeparam name="Policy">What to do when the sum overflows, throw_policy by default</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start + (increment * steps)</returns>
+template <typename T, typename Policy = throw_policy>
+auto add_numbers_compensated(T const& start, T const& increment, unsigned long int const& steps)
+{
+    static_assert(std::is_floating_point<T>::value, "add_numbers_compensated is for real numbers");
+
+    constexpr unsigned long int lanes = 8;
+    constexpr unsigned long int chunk_rounds = 4096;
+    T sums[lanes] = {};
+    T compensations[lanes] = {};
+    unsigned long int remaining = steps;
+
+    // sum in chunks and fold each chunk into the lanes, otherwise with long runs the
+    // compensation grows as large as the sum and starts absorbing increments itself
+    while (remaining >= lanes)
+    {
+        const unsigned long int rounds = std::min(remaining / lanes, chunk_rounds);
+        T chunk_sums[lanes] = {};
+        T chunk_compensations[lanes] = {};
+
+        for (unsigned long int round = 0; round < rounds; ++round)
+        {
+            for (unsigned long int j = 0; j < lanes; ++j)
+            {
+                neumaier_add(chunk_sums[j], chunk_compensations[j], increment);
+            }
+        }
+        for (unsigned long int j = 0; j < lanes; ++j)
+        {
+            neumaier_add(sums[j], compensations[j], chunk_sums[j] + chunk_compensations[j]);
+        }
+        remaining -= rounds * lanes;
+    }
+    for (unsigned long int j = 0; j < remaining; ++j)
+    {
+        neumaier_add(sums[j], compensations[j], increment);
+    }
+
+    T sum = start;
+    T compensation = 0;
+    for (unsigned long int j = 0; j < lanes; ++j)
+    {
+        neumaier_add(sum, compensation, sums[j]);
+        compensation += compensations[j];
+    }
+    return Policy::resolve(check_real_sum<T>(sum + compensation, start, increment, steps));
+}
+
+/// <summary>
+/// Sum of count copies of value at the leaves of the pairwise tree, using eight
+/// independent accumulators so the loop can use SIMD.
+/// </summary>
+template <typename T>
+T pairwise_leaf(T const& value, unsigned long int const& count)
+{
+    constexpr unsigned long int lanes = 8;
+    T sums[lanes] = {};
+
+    for (unsigned long int i = 0; i + lanes <= count; i += lanes)
+    {
+        for (unsigned long int j = 0; j < lanes; ++j)
+        {
+            sums[j] += value;
+        }
+    }
+    for (unsigned long int j = 0; j < count % lanes; ++j)
+    {
+        sums[j] += value;
+    }
+    return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+}
+
+/// <summary>
+/// Pairwise sums of count and count + 1 copies of value. The tree splits n terms
+/// into floor(n / 2) and ceil(n / 2), so each level only ever has two different
+/// subtree sizes; computing each size once gives the full tree's result in
+/// O(log steps) additions plus one leaf.
+/// </summary>
+template <typename T>
+std::pair<T, T> pairwise_copies(T const& value, unsigned long int const& count)
+{
+    constexpr unsigned long int leaf_size = 256;
+
+    if (count < leaf_size)
+    {
+        return { pairwise_leaf(value, count), pairwise_leaf(value, count + 1) };
+    }
+
+    // half and half + 1 copies
+    const std::pair<T, T> halves = pairwise_copies(value, count / 2);
+    if (count % 2 == 0)
+    {
+        return { halves.first + halves.first, halves.first + halves.second };
+    }
+    return { halves.first + halves.second, halves.second + halves.second };
+}
+
+/// <summary>
+/// Pairwise (tree) reduction version of add_numbers for real numbers:
+///   start + (increment * steps)
+/// The error grows with log(steps) instead of steps.
+/// </summary>
+/// <typeparam name="T">float, double or long double</typeparam>
+/// <typeparam name="Policy">What to do when the sum overflows, throw_policy by default</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <returns>start + (increment * steps)</returns>
+template <typename T, typename Policy = throw_policy>
+auto add_numbers_pairwise(T const& start, T const& increment, unsigned long int const& steps)
+{
+    static_assert(std::is_floating_point<T>::value, "add_numbers_pairwise is for real numbers");
+
+    return Policy::resolve(check_real_sum<T>(start + pairwise_copies(increment, steps).first, start, increment, steps));
+}
+
+/// <summary>
+/// Non-throwing evaluation of start + (increment * steps) for a single lane of
+/// add_numbers_batch. Types up to 32 bits are worked in an unsigned type twice
+/// their width, so the check is a multiply and a compare with no branches or
+/// division, which lets the compiler vectorize the lane loop. 64 bit types use
+/// the checked multiply builtin when available and the headroom division otherwise.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="start">The number to start with</param>
+/// <param name="increment">How much to add each step</param>
+/// <param name="steps">The number of steps to iterate</param>
+/// <param name="result">Receives the sum, or start when the lane failed</param>
+/// <returns>true if the sum overflowed or underflowed</returns>
+template <typename T>
+bool add_numbers_lane(T const& start, T const& increment, unsigned long int const& steps, T& result)
+{
+    using narrow = std::make_unsigned_t<T>;
+    using wide = std::conditional_t<sizeof(T) <= 2, std::uint32_t, std::uintmax_t>;
+
+    const bool ascending = !(increment < 0);
+    const wide magnitude = ascending ? wide(narrow(increment)) : wide(narrow(narrow(0) - narrow(increment)));
+    const wide headroom = ascending
+        ? wide(narrow(narrow(std::numeric_limits<T>::max()) - narrow(start)))
+        : wide(narrow(narrow(start) - narrow(std::numeric_limits<T>::min())));
+
+    bool failed;
+    wide delta;
+
+    if constexpr (sizeof(T) <= 4)
+    {
+        // more non-zero steps than the unsigned range of T always leave the range
+        // of T, and clamping the count keeps magnitude * count inside wide
+        const wide limit = std::numeric_limits<narrow>::max();
+        const bool too_many = steps > limit;
+        const wide count = too_many ? limit : wide(steps);
+        delta = magnitude * count;
+        failed = (delta > headroom) | (too_many & (magnitude != 0));
+    }
+    else
+    {
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+        failed = __builtin_mul_overflow(magnitude, wide(steps), &delta) | (delta > headroom);
+#else
+        failed = magnitude != 0 && wide(steps) > integral_headroom_steps<T>(start, magnitude, ascending);
+        delta = magnitude * wide(steps);
+#endif
+    }
+
+    const narrow sum = ascending ? narrow(narrow(start) + narrow(delta)) : narrow(narrow(start) - narrow(delta));
+    result = failed ? start : static_cast<T>(sum);
+    return failed;
+}
+
+#if defined(__AVX2__)
+/// <summary>
+/// AVX2 version of add_numbers_lane for four 32 bit lanes at a time. Each lane is
+/// widened to 64 bits, the product comes from a single 32x32->64 multiply and the
+/// limit test is a compare mask, so no lane can stop the others.
+/// </summary>
+/// <typeparam name="T">A 32 bit integral type</typeparam>
+/// <returns>A 4 bit mask with a bit set for every lane that failed</returns>
+template <typename T>
+unsigned int add_numbers_lanes_avx2(T const* starts, T const* increments, unsigned long int const* steps, T* out)
+{
+    static_assert(sizeof(T) == 4, "the AVX2 lanes are 32 bits wide");
+
+    const __m128i start32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(starts));
+    const __m128i increment32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(increments));
+
+    __m256i start;
+    __m256i increment;
+    __m256i magnitude;
+    if constexpr (std::is_signed<T>::value)
+    {
+        start = _mm256_cvtepi32_epi64(start32);
+        increment = _mm256_cvtepi32_epi64(increment32);
+        // abs(MIN) stays MIN, which read as unsigned is the correct magnitude
+        magnitude = _mm256_cvtepu32_epi64(_mm_abs_epi32(increment32));
+    }
+    else
+    {
+        start = _mm256_cvtepu32_epi64(start32);
+        increment = _mm256_cvtepu32_epi64(increment32);
+        magnitude = increment;
+    }
+
+    __m256i count;
+    if constexpr (sizeof(unsigned long int) == 8)
+    {
+        count = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(steps));
+    }
+    else
+    {
+        count = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(steps)));
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i all = _mm256_set1_epi64x(-1);
+    const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+
+    // same clamp as add_numbers_lane
+    const __m256i too_many = _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_srli_epi64(count, 32), zero), all);
+    count = _mm256_blendv_epi8(count, _mm256_set1_epi64x(0xFFFFFFFFll), too_many);
+
+    const __m256i delta = _mm256_mul_epu32(magnitude, count);
+    const __m256i descending = _mm256_cmpgt_epi64(zero, increment);
+    const __m256i headroom = _mm256_blendv_epi8(
+        _mm256_sub_epi64(_mm256_set1_epi64x(static_cast<long long>(std::numeric_limits<T>::max())), start),
+        _mm256_sub_epi64(start, _mm256_set1_epi64x(static_cast<long long>(std::numeric_limits<T>::min()))),
+        descending);
+
+    // AVX2 only has a signed 64 bit compare, so flip the sign bits for an unsigned one
+    const __m256i exceeded = _mm256_cmpgt_epi64(_mm256_xor_si256(delta, sign), _mm256_xor_si256(headroom, sign));
+    const __m256i moving = _mm256_xor_si256(_mm256_cmpeq_epi64(magnitude, zero), all);
+    const __m256i failed = _mm256_or_si256(exceeded, _mm256_and_si256(too_many, moving));
+
+    __m256i sum = _mm256_blendv_epi8(_mm256_add_epi64(start, delta), _mm256_sub_epi64(start, delta), descending);
+    sum = _mm256_blendv_epi8(sum, start, failed);
+
+    // keep the low 32 bits of every 64 bit lane
+    const __m256i packed = _mm256_permutevar8x32_epi32(sum, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+
+    return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(failed)));
+}
+#endif
+
+/// <summary>
+/// Evaluates start + (increment * steps) for many independent lanes at once.
+/// Instead of throwing on the first failure every lane is computed and the lanes
+/// that would overflow or underflow are reported in failed_lanes, where bit
+/// (i % 64) of word (i / 64) is set when lane i failed. Failed lanes receive their
+/// start value in out.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="starts">The number each lane starts with</param>
+/// <param name="increments">How much each lane adds per step</param>
+/// <param name="steps">The number of steps for each lane</param>
+/// <param name="out">Receives the result of each lane</param>
+/// <param name="failed_lanes">At least (lanes + 63) / 64 words for the failure bitmask</param>
+/// <returns>The number of lanes that failed</returns>
+template <typename T>
+std::size_t add_numbers_batch(std::span<const T> starts, std::span<const T> increments, std::span<const unsigned long int> steps,
+                              std::span<T> out, std::span<std::uint64_t> failed_lanes)
+{
+    static_assert(std::is_integral<T>::value, "add_numbers_batch only supports integral types");
+
+    const std::size_t lanes = starts.size();
+    if (increments.size() != lanes || steps.size() != lanes || out.size() != lanes || failed_lanes.size() < (lanes + 63) / 64)
+    {
+        throw std::invalid_argument("ERROR: add_numbers_batch spans do not match!");
+    }
+
+    std::fill(failed_lanes.begin(), failed_lanes.begin() + (lanes + 63) / 64, std::uint64_t(0));
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == 4)
+    {
+        for (; i + 4 <= lanes; i += 4)
+        {
+            const std::uint64_t mask = add_numbers_lanes_avx2<T>(&starts[i], &increments[i], &steps[i], &out[i]);
+            // i is a multiple of 4, so the four bits never straddle two words
+            failed_lanes[i / 64] |= mask << (i % 64);
+        }
+    }
+#endif
+    // work in blocks that end on a mask word boundary so the lane loop has no
+    // dependency on the mask and can be vectorized, then pack the block's flags
+    for (; i < lanes; )
+    {
+        const std::size_t offset = i % 64;
+        const std::size_t block = std::min<std::size_t>(64 - offset, lanes - i);
+        bool failed[64];
+
+        for (std::size_t j = 0; j < block; ++j)
+        {
+            failed[j] = add_numbers_lane<T>(starts[i + j], increments[i + j], steps[i + j], out[i + j]);
+        }
+
+        std::uint64_t word = 0;
+        for (std::size_t j = 0; j < block; ++j)
+        {
+            word |= std::uint64_t(failed[j]) << (offset + j);
+        }
+        failed_lanes[i / 64] |= word;
+        i += block;
+    }
+
+    std::size_t failures = 0;
+    for (std::size_t w = 0; w < (lanes + 63) / 64; ++w)
+    {
+        failures += std::popcount(failed_lanes[w]);
+    }
+    return failures;
+}
+
+/*
+   Shared counters that must never wrap. Each add runs the single step overflow
+   check of add_numbers_checked on the value it read and only publishes the sum
+   with a compare-exchange, so a concurrent add that would leave the range of T
+   can never be observed by another thread, not even for a moment. A fetch_add
+   followed by a rollback was not used: between the two operations other threads
+   would check their own adds against the wrapped value.
+*/
+
+/// <summary>
+/// An integer counter that many threads can add to at once without locks. An add
+/// that would overflow or underflow leaves the counter as it was and is resolved
+/// by Policy, except saturate_policy which clamps the counter to the limit.
+/// wrap_policy returns the unchanged value, since the counter itself never wraps.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <typeparam name="Policy">What to do when an add is out of range, throw_policy by default</typeparam>
+template <typename T, typename Policy = throw_policy>
+class atomic_checked_counter
+{
+public:
+    static_assert(std::is_integral<T>::value, "atomic_checked_counter only supports integral types");
+
+    explicit atomic_checked_counter(T const& start = T(0)) : value(start) {}
+
+    /// <summary>
+    /// Adds increment to the counter
+    /// </summary>
+    /// <param name="increment">How much to add, negative to count down</param>
+    /// <returns>The value of the counter after the add, resolved by Policy</returns>
+    auto add(T const& increment)
+    {
+        // only the count itself is shared, so no ordering with other memory is needed
+        T current = value.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const checked_result<T> next = add_numbers_checked<T>(current, increment, 1);
+            if (!next && !std::is_same<Policy, saturate_policy>::value)
+            {
+                return Policy::resolve(checked_result<T>{ current, next.error });
+            }
+
+            // on a failed compare-exchange current is reloaded and the check runs again
+            const T desired = saturate_policy::resolve(next);
+            if (value.compare_exchange_weak(current, desired, std::memory_order_relaxed))
+            {
+                return Policy::resolve(checked_result<T>{ desired, next.error });
+            }
+        }
+    }
+
+    T load() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<T> value;
+};
+
+/// <summary>
+/// An atomic_checked_counter split into Shards cache line sized slots so threads
+/// adding at the same time mostly touch different memory. Each thread adds to its
+/// own slot and the total is only summed when it is read.
+/// 
+/// Every slot may only hold 1 / Shards of the range of T, from min() / Shards to
+/// max() / Shards, so the sum of the slots can never leave the range either. When
+/// the slot of a thread is full the add is tried on the other slots before it is
+/// reported. That puts two limits on an add that atomic_checked_counter does not
+/// have: an increment outside [min_increment(), max_increment()] fits no slot and
+/// fails even when the total is 0, and an add fails once no slot has room for it,
+/// which can be while the total is still up to Shards * (increment + 1) away from
+/// the limit. Use atomic_checked_counter when single adds can be that large.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <typeparam name="Policy">What to do when an add is out of range, throw_policy by default</typeparam>
+/// <typeparam name="Shards">The number of slots</typeparam>
+template <typename T, typename Policy = throw_policy, std::size_t Shards = 16>
+class sharded_checked_counter
+{
+public:
+    static_assert(std::is_integral<T>::value, "sharded_checked_counter only supports integral types");
+    static_assert(Shards > 0, "sharded_checked_counter needs at least one shard");
+
+    /// <summary>
+    /// The largest increment a single add can take, the room of an empty slot
+    /// </summary>
+    static constexpr T max_increment()
+    {
+        return std::numeric_limits<T>::max() / T(Shards);
+    }
+
+    /// <summary>
+    /// The most negative increment a single add can take, 0 for unsigned types
+    /// </summary>
+    static constexpr T min_increment()
+    {
+        return std::numeric_limits<T>::min() / T(Shards);
+    }
+
+    /// <summary>
+    /// Adds increment to the counter
+    /// </summary>
+    /// <param name="increment">How much to add, negative to count down</param>
+    /// <returns>The value of the slot that was added to, or the total when the add failed, resolved by Policy</returns>
+    auto add(T const& increment)
+    {
+        // too large for any slot, there is no need to try them all
+        if (increment > max_increment() || increment < min_increment())
+        {
+            return Policy::resolve(checked_result<T>{ load(), increment > 0 ? numeric_error::overflow : numeric_error::underflow });
+        }
+
+        const std::size_t home = shard_index();
+        numeric_error error = numeric_error::none;
+
+        for (std::size_t i = 0; i < Shards; ++i)
+        {
+            std::atomic<T>& slot = shards[(home + i) % Shards].value;
+            T current = slot.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                error = slot_add(current, increment);
+                if (error != numeric_error::none)
+                {
+                    break;
+                }
+
+                const T desired = static_cast<T>(current + increment);
+                if (slot.compare_exchange_weak(current, desired, std::memory_order_relaxed))
+                {
+                    return Policy::resolve(checked_result<T>{ desired, numeric_error::none });
+                }
+            }
+        }
+
+        // every slot is full, the total is as close to the limit as this increment allows
+        return Policy::resolve(checked_result<T>{ load(), error });
+    }
+
+    /// <summary>
+    /// Sums the slots. Adds that happen during the sum may or may not be included.
+    /// </summary>
+    T load() const
+    {
+        T total = 0;
+        for (auto& shard : shards)
+        {
+            total = static_cast<T>(total + shard.value.load(std::memory_order_relaxed));
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) shard
+    {
+        std::atomic<T> value{ 0 };
+    };
+
+    shard shards[Shards];
+
+    /// <summary>
+    /// Checks current + increment against the share of the range each slot may hold
+    /// </summary>
+    static numeric_error slot_add(T const& current, T const& increment)
+    {
+        const T upper = max_increment();
+        const T lower = min_increment();
+
+        const checked_result<T> next = add_numbers_checked<T>(current, increment, 1);
+        if (next.error != numeric_error::none)
+        {
+            return next.error;
+        }
+        if (next.value > upper)
+        {
+            return numeric_error::overflow;
+        }
+        if (next.value < lower)
+        {
+            return numeric_error::underflow;
+        }
+        return numeric_error::none;
+    }
+
+    /// <summary>
+    /// Hands out slots to threads round robin on their first add
+    /// </summary>
+    static std::size_t shard_index()
+    {
+        static std::atomic<std::size_t> next_shard(0);
+        thread_local const std::size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % Shards;
+        return index;
+    }
+};
+
+/*
+   Runtime dispatch for streams where the integer type of each record is only
+   known at runtime. Switching on the type of every record puts an unpredictable
+   branch and a call into a different template in front of each add. The engine
+   instead sorts the records by type in one counting pass, then calls the batch
+   kernel for each type once over all of its records, so there is one indirect
+   call per type instead of one switch per record.
+*/
+
+/// <summary>
+/// The integer types a numeric_record can hold
+/// </summary>
+enum class numeric_type : unsigned char
+{
+    int8,
+    uint8,
+    int16,
+    uint16,
+    int32,
+    uint32,
+    int64,
+    uint64
+};
+
+constexpr std::size_t numeric_type_count = 8;
+
+/// <summary>
+/// The name of a numeric_type for reports
+/// </summary>
+constexpr const char* numeric_type_name(numeric_type const& type)
+{
+    constexpr const char* names[numeric_type_count] = { "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64" };
+    return names[static_cast<std::size_t>(type)];
+}
+
+/// <summary>
+/// One start + (increment * steps) whose type is chosen at runtime. start and
+/// increment hold the bits of the value converted to 64 bits, so converting them
+/// back with static_cast gives the original value of the record's type.
+/// </summary>
+struct numeric_record
+{
+    numeric_type type;
+    std::uint64_t start;
+    std::uint64_t increment;
+    unsigned long int steps;
+};
+
+/// <summary>
+/// Evaluates a single record by switching on its type
+/// </summary>
+/// <param name="record">The record to evaluate</param>
+/// <returns>The result converted to 64 bits, or the wrapped result and the limit that was crossed</returns>
+inline checked_result<std::uint64_t> add_numbers_record(numeric_record const& record)
+{
+    auto evaluate = [&record](auto zero) -> checked_result<std::uint64_t> {
+        using T = decltype(zero);
+        const checked_result<T> result = add_numbers_checked<T>(static_cast<T>(record.start), static_cast<T>(record.increment), record.steps);
+        return { static_cast<std::uint64_t>(result.value), result.error };
+    };
+
+    switch (record.type)
+    {
+    case numeric_type::int8: return evaluate(std::int8_t(0));
+    case numeric_type::uint8: return evaluate(std::uint8_t(0));
+    case numeric_type::int16: return evaluate(std::int16_t(0));
+    case numeric_type::uint16: return evaluate(std::uint16_t(0));
+    case numeric_type::int32: return evaluate(std::int32_t(0));
+    case numeric_type::uint32: return evaluate(std::uint32_t(0));
+    case numeric_type::int64: return evaluate(std::int64_t(0));
+    case numeric_type::uint64: return evaluate(std::uint64_t(0));
+    }
+    throw std::invalid_argument("ERROR: Unknown numeric_type!");
+}
+
+/// <summary>
+/// How one type fared in a run of numeric_dispatch_engine
+/// </summary>
+struct numeric_dispatch_stats
+{
+    std::size_t records = 0;
+    std::size_t failures = 0;
+    double nanoseconds = 0;
+
+    /// <summary>
+    /// Millions of records per second, 0 when there were none
+    /// </summary>
+    double throughput() const
+    {
+        return nanoseconds > 0 ? records * 1000.0 / nanoseconds : 0;
+    }
+};
+
+/// <summary>
+/// Evaluates mixed-type streams of numeric_record by grouping them into one batch
+/// per type. The results are written in the order of the records, with the same
+/// contract as add_numbers_batch: a record that fails reports start and whether it
+/// overflowed or underflowed. The engine keeps its scratch space between runs.
+/// </summary>
+class numeric_dispatch_engine
+{
+public:
+    /// <summary>
+    /// Evaluates every record
+    /// </summary>
+    /// <param name="records">The records to evaluate</param>
+    /// <param name="out">Receives the result of each record, the same size as records</param>
+    /// <returns>The counts and time spent for each type, indexed by numeric_type</returns>
+    std::array<numeric_dispatch_stats, numeric_type_count> const& run(std::span<const numeric_record> records, std::span<checked_result<std::uint64_t>> out)
+    {
+        if (out.size() != records.size())
+        {
+            throw std::invalid_argument("ERROR: numeric_dispatch_engine spans do not match!");
+        }
+
+        // counting sort of the record indices by type
+        std::array<std::size_t, numeric_type_count + 1> offsets = {};
+        for (auto& record : records)
+        {
+            const std::size_t type = static_cast<std::size_t>(record.type);
+            if (type >= numeric_type_count)
+            {
+                throw std::invalid_argument("ERROR: Unknown numeric_type!");
+            }
+            ++offsets[type + 1];
+        }
+        for (std::size_t t = 0; t < numeric_type_count; ++t)
+        {
+            offsets[t + 1] += offsets[t];
+        }
+
+        order.resize(records.size());
+        std::array<std::size_t, numeric_type_count> next = {};
+        std::copy(offsets.begin(), offsets.end() - 1, next.begin());
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            order[next[static_cast<std::size_t>(records[i].type)]++] = i;
+        }
+
+        for (std::size_t t = 0; t < numeric_type_count; ++t)
+        {
+            numeric_dispatch_stats& type_stats = stats[t];
+            type_stats = numeric_dispatch_stats();
+            type_stats.records = offsets[t + 1] - offsets[t];
+            if (type_stats.records == 0)
+            {
+                continue;
+            }
+
+            const auto begin = std::chrono::steady_clock::now();
+            type_stats.failures = kernels[t](records, std::span<const std::size_t>(order).subspan(offsets[t], type_stats.records), out);
+            const auto end = std::chrono::steady_clock::now();
+            type_stats.nanoseconds = std::chrono::duration<double, std::nano>(end - begin).count();
+        }
+        return stats;
+    }
+
+private:
+    using batch_kernel = std::size_t (*)(std::span<const numeric_record>, std::span<const std::size_t>, std::span<checked_result<std::uint64_t>>);
+
+    // a block of lanes small enough for the gathered copies to stay in cache
+    static constexpr std::size_t block_size = 1024;
+
+    /// <summary>
+    /// Gathers the records of type T block by block, runs add_numbers_batch on each
+    /// block and scatters the results back to their positions in out
+    /// </summary>
+    /// <returns>The number of records that failed</returns>
+    template <typename T>
+    static std::size_t run_batch(std::span<const numeric_record> records, std::span<const std::size_t> indices, std::span<checked_result<std::uint64_t>> out)
+    {
+        T starts[block_size];
+        T increments[block_size];
+        unsigned long int steps[block_size];
+        T results[block_size];
+        std::uint64_t failed[block_size / 64];
+        std::size_t failures = 0;
+
+        for (std::size_t first = 0; first < indices.size(); first += block_size)
+        {
+            const std::size_t count = std::min(block_size, indices.size() - first);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                numeric_record const& record = records[indices[first + j]];
+                starts[j] = static_cast<T>(record.start);
+                increments[j] = static_cast<T>(record.increment);
+                steps[j] = record.steps;
+            }
+
+            failures += add_numbers_batch<T>(std::span<const T>(starts, count), std::span<const T>(increments, count),
+                                             std::span<const unsigned long int>(steps, count), std::span<T>(results, count), failed);
+
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                const bool lane_failed = (failed[j / 64] >> (j % 64)) & 1;
+                const numeric_error error = !lane_failed ? numeric_error::none
+                    : increments[j] < 0 ? numeric_error::underflow : numeric_error::overflow;
+                out[indices[first + j]] = { static_cast<std::uint64_t>(results[j]), error };
+            }
+        }
+        return failures;
+    }
+
+    // indexed by numeric_type
+    static constexpr batch_kernel kernels[numeric_type_count] = {
+        &run_batch<std::int8_t>, &run_batch<std::uint8_t>, &run_batch<std::int16_t>, &run_batch<std::uint16_t>,
+        &run_batch<std::int32_t>, &run_batch<std::uint32_t>, &run_batch<std::int64_t>, &run_batch<std::uint64_t>
+    };
+
+    std::vector<std::size_t> order;
+    std::array<numeric_dispatch_stats, numeric_type_count> stats = {};
+};
+
+/*
+   Overflow telemetry. Writing every failure to std::cout is synchronous and slow
+   under load, so failures can instead be counted by type and call site. Each
+   thread counts into its own table with plain relaxed stores, so recording an
+   event takes no lock and no read-modify-write. A snapshot sums the tables of
+   every thread while they keep counting, and numeric_telemetry_monitor takes one
+   periodically on a background thread. When a thread exits its counts are folded
+   into one retired total and its table is freed, so short-lived threads such as
+   the workers of run_test_matrix do not each keep a table for good.
+*/
+
+constexpr std::size_t numeric_error_count = static_cast<std::size_t>(numeric_error::count);
+
+/// <summary>
+/// Where a numeric error happened and for which type. The strings come from
+/// typeid and std::source_location and are compared by address.
+/// </summary>
+struct numeric_event_site
+{
+    const char* type;
+    const char* file;
+    const char* function;
+    std::uint_least32_t line;
+
+    bool operator==(numeric_event_site const& other) const = default;
+};
+
+/// <summary>
+/// Orders sites by source location and then by type, comparing the strings by
+/// their text so the order is the same in every run
+/// </summary>
+inline bool numeric_site_before(numeric_event_site const& a, numeric_event_site const& b)
+{
+    if (const int order = std::strcmp(a.file, b.file); order != 0)
+    {
+        return order < 0;
+    }
+    if (a.line != b.line)
+    {
+        return a.line < b.line;
+    }
+    if (const int order = std::strcmp(a.function, b.function); order != 0)
+    {
+        return order < 0;
+    }
+    return std::strcmp(a.type, b.type) < 0;
+}
+
+/// <summary>
+/// How many errors of each kind were counted at one site, indexed by numeric_error
+/// </summary>
+struct numeric_event_count
+{
+    numeric_event_site site;
+    std::uint64_t events[numeric_error_count];
+};
+
+/// <summary>
+/// The counts of every thread summed by site
+/// </summary>
+struct numeric_telemetry_snapshot
+{
+    std::vector<numeric_event_count> sites;
+    std::uint64_t dropped = 0;   // events at sites past the capacity of a thread's table
+};
+
+/// <summary>
+/// The per-thread event tables and the registry of all of them
+/// </summary>
+class numeric_telemetry
+{
+public:
+    /// <summary>
+    /// Counts one error at site for the calling thread
+    /// </summary>
+    static void record(numeric_event_site const& site, numeric_error const& error)
+    {
+        local_table().record(site, error);
+    }
+
+    /// <summary>
+    /// Sums the counts of every thread that has recorded an event, including threads
+    /// that have exited, sorted by numeric_site_before. Events recorded during the
+    /// snapshot may or may not be included.
+    /// </summary>
+    static numeric_telemetry_snapshot snapshot()
+    {
+        numeric_telemetry_snapshot result;
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            result = retired();
+
+            for (auto table : registry())
+            {
+                add_counts(result, *table);
+            }
+        }
+
+        // the tables are in thread and hash order, which changes from run to run
+        std::sort(result.sites.begin(), result.sites.end(), [](numeric_event_count const& a, numeric_event_count const& b) {
+            return numeric_site_before(a.site, b.site);
+        });
+        return result;
+    }
+
+private:
+    static constexpr std::size_t capacity = 128;
+
+    struct slot
+    {
+        std::atomic<bool> used{ false };
+        numeric_event_site site = {};
+        std::atomic<std::uint64_t> events[numeric_error_count] = {};
+    };
+
+    struct table
+    {
+        slot slots[capacity];
+        std::atomic<std::uint64_t> dropped{ 0 };
+
+        /// <summary>
+        /// Only the owning thread writes, so a relaxed load and store is enough to count
+        /// </summary>
+        static void increment(std::atomic<std::uint64_t>& counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void record(numeric_event_site const& site, numeric_error const& error)
+        {
+            // open addressing on the site, a call site almost always hits its first probe
+            const std::size_t hash = std::hash<const void*>()(site.file) ^ std::hash<const void*>()(site.type) * 31 ^ site.line * 131;
+            for (std::size_t probe = 0; probe < capacity; ++probe)
+            {
+                slot& candidate = slots[(hash + probe) % capacity];
+                if (!candidate.used.load(std::memory_order_relaxed))
+                {
+                    candidate.site = site;
+                    candidate.used.store(true, std::memory_order_release);
+                }
+                if (candidate.site == site)
+                {
+                    increment(candidate.events[static_cast<std::size_t>(error)]);
+                    return;
+                }
+            }
+            increment(dropped);
+        }
+    };
+
+    /// <summary>
+    /// Owns the table of one thread and registers it for as long as the thread runs
+    /// </summary>
+    struct registration
+    {
+        std::unique_ptr<table> owned = std::make_unique<table>();
+
+        registration()
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            registry().push_back(owned.get());
+        }
+
+        /// <summary>
+        /// Keeps the counts of the exiting thread in the retired total and frees its table
+        /// </summary>
+        ~registration()
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            add_counts(retired(), *owned);
+            std::erase(registry(), owned.get());
+        }
+    };
+
+    /// <summary>
+    /// Adds the counts of one table to a snapshot, merging them by site
+    /// </summary>
+    static void add_counts(numeric_telemetry_snapshot& into, table const& from)
+    {
+        into.dropped += from.dropped.load(std::memory_order_relaxed);
+        for (auto& slot : from.slots)
+        {
+            // the site is written before used is set, so it is complete once used is seen
+            if (!slot.used.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            auto match = std::find_if(into.sites.begin(), into.sites.end(), [&slot](numeric_event_count const& count) {
+                return count.site == slot.site;
+            });
+            if (match == into.sites.end())
+            {
+                match = into.sites.insert(into.sites.end(), { slot.site, {} });
+            }
+            for (std::size_t e = 0; e < numeric_error_count; ++e)
+            {
+                match->events[e] += slot.events[e].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static std::mutex& registry_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /// <summary>
+    /// The tables of the running threads that have recorded an event
+    /// </summary>
+    static std::vector<table*>& registry()
+    {
+        static std::vector<table*> tables;
+        return tables;
+    }
+
+    /// <summary>
+    /// The counts of the threads that have exited
+    /// </summary>
+    static numeric_telemetry_snapshot& retired()
+    {
+        static numeric_telemetry_snapshot counts;
+        return counts;
+    }
+
+    static table& local_table()
+    {
+        // registered on the first event of each thread, the only time the mutex is taken
+        thread_local const registration local;
+        return *local.owned;
+    }
+};
+
+/// <summary>
+/// Counts error for type T at the caller's source location. Nothing is counted for numeric_error::none.
+/// </summary>
+/// <typeparam name="T">The type the error happened with</typeparam>
+/// <param name="error">What went wrong</param>
+/// <param name="location">The call site, filled in by the compiler</param>
+template <typename T>
+void record_numeric_error(numeric_error const& error, std::source_location const& location = std::source_location::current())
+{
+    if (error != numeric_error::none)
+    {
+        numeric_telemetry::record({ typeid(T).name(), location.file_name(), location.function_name(), location.line() }, error);
+    }
+}
+
+/// <summary>
+/// Passes result through and counts it when it failed, so a hot path can monitor a
+/// checked call without printing: count_numeric_errors(add_numbers_checked(a, b, n))
+/// </summary>
+/// <param name="result">The result of a checked kernel</param>
+/// <param name="location">The call site, filled in by the compiler</param>
+/// <returns>result</returns>
+template <typename T>
+checked_result<T> count_numeric_errors(checked_result<T> const& result, std::source_location const& location = std::source_location::current())
+{
+    record_numeric_error<T>(result.error, location);
+    return result;
+}
+
+/// <summary>
+/// Calls report with a numeric_telemetry snapshot every interval on a background
+/// thread until destroyed
+/// </summary>
+class numeric_telemetry_monitor
+{
+public:
+    numeric_telemetry_monitor(std::chrono::milliseconds const& interval, std::function<void(numeric_telemetry_snapshot const&)> report)
+        : worker([interval, report](std::stop_token stop) {
+              std::mutex mutex;
+              std::condition_variable_any wake;
+              std::unique_lock<std::mutex> lock(mutex);
+
+              // wakes early when the monitor is destroyed
+              while (!wake.wait_for(lock, stop, interval, [&stop]() { return stop.stop_requested(); }))
+              {
+                  report(numeric_telemetry::snapshot());
+              }
+          })
+    {
+    }
+
+private:
+    std::jthread worker;
+};
+
+/// <summary>
+/// Prints a snapshot as one line per site
+/// </summary>
+/// <param name="snapshot">The counts to print</param>
+/// <param name="out">Where the counts are printed</param>
+void print_numeric_telemetry(numeric_telemetry_snapshot const& snapshot, std::ostream& out = std::cout)
+{
+    for (auto& count : snapshot.sites)
+    {
+        out << "\t" << count.site.type << " at " << count.site.function << " line " << count.site.line << ": "
+            << count.events[static_cast<std::size_t>(numeric_error::overflow)] << " overflow, "
+            << count.events[static_cast<std::size_t>(numeric_error::underflow)] << " underflow, "
+            << count.events[static_cast<std::size_t>(numeric_error::precision_loss)] << " precision loss, "
+            << count.events[static_cast<std::size_t>(numeric_error::division_by_zero)] << " division by zero" << std::endl;
+    }
+    if (snapshot.dropped != 0)
+    {
+        out << "\t" << snapshot.dropped << " events past the table capacity" << std::endl;
+    }
+}
+
+
+/*
+   The tests run on worker threads (see run_test_matrix) and write their reports
+   to a stream they are given, but the protected lines at the top of each test
+   still write to std::cout. While the matrix runs std::cout is given a buffer
+   that sends each thread's output to the report of the task it is running, and
+   the protected lines hold console_mutex because the formatting state of
+   std::cout is shared by every thread.
+*/
+
+/// <summary>
+/// A stream buffer for std::cout that forwards each thread's output to the buffer
+/// the thread selected with target(), or to the console when it selected none
+/// </summary>
+class thread_console_buffer : public std::streambuf
+{
+public:
+    explicit thread_console_buffer(std::streambuf* console) : console(console) {}
+
+    /// <summary>
+    /// The buffer output goes to when a thread has no target
+    /// </summary>
+    std::streambuf* console_buffer() const
+    {
+        return console;
+    }
+
+    /// <summary>
+    /// Where the calling thread's console output goes, nullptr for the console
+    /// </summary>
+    static std::streambuf*& target()
+    {
+        thread_local std::streambuf* buffer = nullptr;
+        return buffer;
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        std::streambuf* buffer = current();
+        if (buffer == nullptr || traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            return buffer == nullptr ? traits_type::eof() : traits_type::not_eof(ch);
+        }
+        return buffer->sputc(traits_type::to_char_type(ch));
+    }
+
+    std::streamsize xsputn(const char* text, std::streamsize count) override
+    {
+        std::streambuf* buffer = current();
+        return buffer == nullptr ? 0 : buffer->sputn(text, count);
+    }
+
+    int sync() override
+    {
+        std::streambuf* buffer = current();
+        return buffer == nullptr ? -1 : buffer->pubsync();
+    }
+
+private:
+    std::streambuf* current() const
+    {
+        return target() != nullptr ? target() : console;
+    }
+
+    std::streambuf* console;
+};
+
+/// <summary>
+/// Held by the tests while they write to std::cout directly
+/// </summary>
+std::mutex& console_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+//  NOTE:
+//    You will see the unary ('+') operator used in front of the variables in the test_XXX methods.
+//    This forces the output to be a number for cases where cout would assume it is a character. 
+
+template <typename T>
+void test_overflow(std::ostream& out = std::cout)
+{
+    // TODO: The add_numbers template function will overflow in the second method call
+    //        You need to change the add_numbers method to:
+    //        1. Detect when an overflow will happen
+    //        2. Prevent it from happening
+    //        3. Return the correct value when no overflow happened or
+    //        4. Return something to tell test_overflow the addition failed
+    //        NOTE: The add_numbers method must remain a template in the NumericFunctions header.
+    //
+    //        You need to change the test_overflow method to:
+    //        1. Detect when an add_numbers failed
+    //        2. Inform the user the overflow happened
+    //        3. A successful result displays the same result as before you changed the method
+    //        NOTE: You cannot change anything between START / END DO NOT CHANGE
+    //              The test_overflow method must remain a template in the NumericOverflows source file
+    //
+    //  There are more than one possible solution to this problem. 
+    //  The solution must work for all of the data types used to call test_overflow() in main().
+
+    // the protected lines write to std::cout, which run_test_matrix sends to this test's report
+    std::unique_lock<std::mutex> console_lock(console_mutex());
+    // START DO NOT CHANGE
+    //  how many times will we iterate
+    const unsigned long int steps = 5;
+    // how much will we add each step (result should be: start + (increment * steps))
+    const T increment = std::numeric_limits<T>::max() / steps;
+    // whats our starting point
+    const T start = 0;
+
+    std::cout << "Overflow Test of Type = " << typeid(T).name() << std::endl;
+    // END DO NOT CHANGE
+    console_lock.unlock();
+
+
+    /*
+    * -------------------------CHANGES-----------------------------------------------
+        Try to add the numbers and catch an overflow, underflow, or unkown exception
+        and handle it by printing an error message to the console
+     --------------------------------------------------------------------------------
+    */
+
+    // No overflow test
+    T result;
+    out << "\tAdding Numbers Without Overflow (" << +start << ", " << +increment << ", " << steps << ") = ";
+   
+    try
+    {
+        result = add_numbers<T>(start, increment, steps); // Attempt to add the numbers
+        out << +result << '\n'; // Display the result of the addition
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR Unknown Addition Error " << e.what() << '\n';
+    }
+
+    // Overflow test
+    out << "\tAdding Numbers With Overflow (" << +start << ", " << +increment << ", " << (steps + 1) << ") = ";
+   
+    try
+    {
+        result = add_numbers<T>(start, increment, steps + 1); // Attempt to add the numbers
+        out << +result; // Display the result of the addition
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR Unknown Addition Error " << e.what() << '\n';
+    }
+    out << '\n';
+}
+
+
+/*
+   -------------------------CHANGES---------------------------------------------------
+      Added a new template method specifically for testing signed integer overflow.
+      Can be used to check that an underflow exception is generate if add_numbers
+      is inadvertanly used to subtract numbers. Currently it is setup to test
+      the same overflow case as test_overflow()
+   -----------------------------------------------------------------------------------
+*/
+template <typename T>
+void test_overflow_signed(std::ostream& out = std::cout)
+{
+    // TODO: The add_numbers template function will overflow in the second method call
     //        You need to change the add_numbers method to:
     //        1. Detect when an overflow will happen
     //        2. Prevent it from happening
@@ -214,299 +3541,2014 @@ void test_overflow_signed()
     //  There are more than one possible solution to this problem. 
     //  The solution must work for all of the data types used to call test_overflow() in main().
 
-    // START DO NOT CHANGE
-    //  how many times will we iterate
-    const unsigned long int steps = 5;
-    // how much will we add each step (result should be: start + (increment * steps))
-    const T increment = std::numeric_limits<T>::max() / steps;
-    // whats our starting point
-    const T start = 0;
+    // the protected lines write to std::cout, which run_test_matrix sends to this test's report
+    std::unique_lock<std::mutex> console_lock(console_mutex());
+    // START DO NOT CHANGE
+    //  how many times will we iterate
+    const unsigned long int steps = 5;
+    // how much will we add each step (result should be: start + (increment * steps))
+    const T increment = std::numeric_limits<T>::max() / steps;
+    // whats our starting point
+    const T start = 0;
+
+    std::cout << "Overflow Test of Type = " << typeid(T).name() << std::endl;
+    // END DO NOT CHANGE
+    console_lock.unlock();
+
+
+    /*
+    * -------------------------CHANGES-----------------------------------------------
+        Try to add the numbers and catch an overflow, underflow, or unkown exception
+        and handle it by printing an error message to the console
+     --------------------------------------------------------------------------------
+    */
+
+    // No overflow test
+    T result;
+    out << "\tAdding Numbers Without Overflow (" << +start << ", " << +increment << ", " << steps << ") = ";
+
+    try
+    {
+        result = add_numbers<T>(start, increment, steps); // Attempt to add the numbers
+        out << +result << '\n'; // Display the result of the addition
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR Unknown Addition Error " << e.what() << '\n';
+    }
+
+    // Overflow test
+    out << "\tAdding Numbers With Overflow (" << +start << ", " << +increment << ", " << (steps + 1) << ") = ";
+
+    try
+    {
+        result = add_numbers<T>(start, increment, steps + 1); // Attempt to add the numbers
+        out << +result; // Display the result of the addition
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR Unknown Addition Error " << e.what() << '\n';
+    }
+    out << '\n';
+}
+
+template <typename T>
+void test_underflow(std::ostream& out = std::cout)
+{
+    // TODO: The subtract_numbers template function will underflow in the second method call
+    //        You need to change the subtract_numbers method to:
+    //        1. Detect when an underflow will happen
+    //        2. Prevent it from happening
+    //        3. Return the correct value when no underflow happened or
+    //        4. Return something to tell test_underflow the subtraction failed
+    //        NOTE: The subtract_numbers method must remain a template in the NumericFunctions header.
+    //
+    //        You need to change the test_underflow method to:
+    //        1. Detect when an subtract_numbers failed
+    //        2. Inform the user the underflow happened
+    //        3. A successful result displays the same result as before you changed the method
+    //        NOTE: You cannot change anything between START / END DO NOT CHANGE
+    //              The test_underflow method must remain a template in the NumericOverflows source file
+    //
+    //  There are more than one possible solution to this problem. 
+    //  The solution must work for all of the data types used to call test_overflow() in main().
+
+    // the protected lines write to std::cout, which run_test_matrix sends to this test's report
+    std::unique_lock<std::mutex> console_lock(console_mutex());
+    // START DO NOT CHANGE
+    //  how many times will we iterate
+    const unsigned long int steps = 5;
+    // how much will we subtract each step (result should be: start - (increment * steps))
+    const T decrement = std::numeric_limits<T>::max() / steps;
+    // whats our starting point
+    const T start = std::numeric_limits<T>::max();
+
+    std::cout << "Underflow Test of Type = " << typeid(T).name() << std::endl;
+    // END DO NOT CHANGE
+    console_lock.unlock();
+
+    /*
+    * -------------------------CHANGES---------------------------------------------------
+        Try to subtract the numbers and catch an overflow, underflow, or unkown exception
+        and handle it by printing an error message to the console
+     ------------------------------------------------------------------------------------
+    */
+
+    // No underflow test
+    T result;
+    out << "\tSubtracting Numbers Without Overflow (" << +start << ", " << +decrement << ", " << steps << ") = ";
+    try
+    {
+        result = subtract_numbers<T>(start, decrement, steps); // Attempt to subtract the numbers
+        out << +result << '\n'; // Display the result of the subtraction
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+    }
+
+    // Underflow test
+    out << "\tSubtracting Numbers With Overflow (" << +start << ", " << +decrement << ", " << (steps + 1) << ") = ";
+    try
+    {
+        result = subtract_numbers<T>(start, decrement, steps + 1); // Attempt to subtract the numbers
+        out << +result << '\n'; // Display the result of the subtraction
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+    }
+    out << '\n';
+}
+
+/*
+   -------------------------CHANGES---------------------------------------------------
+      Added a new template method specifically for testing signed integer underflow.
+      Starts at MIN + 5 and decrements by 1 until steps or steps + 1.
+   -----------------------------------------------------------------------------------
+*/
+template <typename T>
+void test_underflow_signed(std::ostream& out = std::cout)
+{
+    //  how many times will we iterate
+    const unsigned long int steps = 5;
+    // how much will we subtract each step (result should be: start - (increment * steps))
+    const T decrement = 1;
+    // whats our starting point
+    const T start = std::numeric_limits<T>::min() + 5;
+
+    out << "Underflow Test of Type = " << typeid(T).name() << std::endl;
+ 
+    /*
+    * -------------------------CHANGES---------------------------------------------------
+        Try to subtract the numbers and catch an overflow, underflow, or unkown exception
+        and handle it by printing an error message to the console
+     ------------------------------------------------------------------------------------
+    */
+
+    // No underflow test
+    T result;
+    out << "\tSubtracting Numbers Without Overflow (" << +start << ", " << +decrement << ", " << steps << ") = ";
+    try
+    {
+        result = subtract_numbers<T>(start, decrement, steps); // Attempt to subtract the numbers
+        out << +result << '\n'; // Display the result of the subtraction
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+    }
+
+    // Underflow test
+    out << "\tSubtracting Numbers With Overflow (" << +start << ", " << +decrement << ", " << (steps + 1) << ") = ";
+    try
+    {
+        result = subtract_numbers<T>(start, decrement, steps + 1); // Attempt to subtract the numbers
+        out << +result << '\n'; // Display the result of the subtraction
+    }
+    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    {
+        record_numeric_error<T>(numeric_error::overflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    {
+        record_numeric_error<T>(numeric_error::underflow); // Count it for the telemetry
+        out << e.what() << '\n'; // Display the exception message to the user
+    }
+    catch (const std::exception& e)
+    {
+        out << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+    }
+    out << '\n';
+}
+
+/// <summary>
+/// Calls body(i) for every i in [0, count) on a small pool of worker threads that
+/// take the next index as they become free. The calling thread works too.
+/// </summary>
+/// <param name="count">How many indices to process</param>
+/// <param name="body">The work for a single index</param>
+template <typename Body>
+void parallel_for(std::size_t const& count, Body body)
+{
+    std::atomic<std::size_t> next_index(0);
+
+    auto worker = [&]() {
+        for (std::size_t i = next_index++; i < count; i = next_index++)
+        {
+            body(i);
+        }
+    };
+
+    const std::size_t thread_count = std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < thread_count; ++t)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+}
+
+/// <summary>
+/// Runs every task with parallel_for. Each task writes into its own buffer and
+/// the buffers are printed in the order the tasks were given, so the output is
+/// the same as running them one after another but the wall time is closer to
+/// that of the slowest task.
+/// </summary>
+/// <param name="tasks">The tests to run, each writing its report to the given stream</param>
+/// <param name="out">Where the reports are printed</param>
+void run_test_matrix(std::vector<std::function<void(std::ostream&)>> const& tasks, std::ostream& out = std::cout)
+{
+    std::vector<std::ostringstream> reports(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+
+    // anything a task writes to std::cout goes to its report as well
+    thread_console_buffer console(std::cout.rdbuf());
+    std::cout.rdbuf(&console);
+
+    parallel_for(tasks.size(), [&](std::size_t i) {
+        thread_console_buffer::target() = reports[i].rdbuf();
+        try
+        {
+            tasks[i](reports[i]);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+        thread_console_buffer::target() = nullptr;
+    });
+
+    std::cout.rdbuf(console.console_buffer());
+
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        out << reports[i].str();
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+}
+
+void do_overflow_tests(const std::string& star_line)
+{
+    std::cout << std::endl << star_line << std::endl;
+    std::cout << "*** Running Overflow Tests ***" << std::endl;
+    std::cout << star_line << std::endl;
+
+    /*
+   -------------------------CHANGES---------------------------------------------------
+      Using new template function test_overflow_signed for signed integers
+   -----------------------------------------------------------------------------------
+    */
+
+    // Testing C++ primitive times see: https://www.geeksforgeeks.org/c-data-types/
+    run_test_matrix({
+        [](std::ostream& out) { test_overflow_signed<char>(out); },
+        [](std::ostream& out) { test_overflow_signed<short int>(out); },
+        [](std::ostream& out) { test_overflow_signed<int>(out); },
+        [](std::ostream& out) { test_overflow_signed<long>(out); },
+        [](std::ostream& out) { test_overflow_signed<long long>(out); },
+
+        // unsigned integers
+        [](std::ostream& out) { test_overflow<unsigned char>(out); },
+        [](std::ostream& out) { test_overflow<wchar_t>(out); },
+        [](std::ostream& out) { test_overflow<unsigned short int>(out); },
+        [](std::ostream& out) { test_overflow<unsigned int>(out); },
+        [](std::ostream& out) { test_overflow<unsigned long>(out); },
+        [](std::ostream& out) { test_overflow<unsigned long long>(out); },
+
+        // real numbers
+        [](std::ostream& out) { test_overflow<float>(out); },
+        [](std::ostream& out) { test_overflow<double>(out); },
+        [](std::ostream& out) { test_overflow<long double>(out); },
+
+        // wide integers
+        [](std::ostream& out) { test_overflow_signed<wide_int128>(out); },
+        [](std::ostream& out) { test_overflow_signed<wide_int256>(out); },
+        [](std::ostream& out) { test_overflow<wide_uint128>(out); },
+        [](std::ostream& out) { test_overflow<wide_uint256>(out); }
+    });
+}
+
+void do_underflow_tests(const std::string& star_line)
+{
+    std::cout << std::endl << star_line << std::endl;
+    std::cout << "*** Running Underflow Tests ***" << std::endl;
+    std::cout << star_line << std::endl;
+
+
+    // Testing C++ primitive times see: https://www.geeksforgeeks.org/c-data-types/
+    /*
+     -------------------------CHANGES---------------------------------------------------
+        Modified the do_underflow_tests function to call the new test_underflow_signed
+        function in order to actually test signed integer underflow
+     ------------------------------------------------------------------------------------
+    */
+   
+    run_test_matrix({
+        // signed integers
+        [](std::ostream& out) { test_underflow_signed<char>(out); },
+        [](std::ostream& out) { test_underflow_signed<short int>(out); },
+        [](std::ostream& out) { test_underflow_signed<int>(out); },
+        [](std::ostream& out) { test_underflow_signed<long>(out); },
+        [](std::ostream& out) { test_underflow_signed<long long>(out); },
+
+        // unsigned integers
+        [](std::ostream& out) { test_underflow<unsigned char>(out); },
+        [](std::ostream& out) { test_underflow<wchar_t>(out); },
+        [](std::ostream& out) { test_underflow<unsigned short int>(out); },
+        [](std::ostream& out) { test_underflow<unsigned int>(out); },
+        [](std::ostream& out) { test_underflow<unsigned long>(out); },
+        [](std::ostream& out) { test_underflow<unsigned long long>(out); },
+
+        // real numbers
+        [](std::ostream& out) { test_underflow<float>(out); },
+        [](std::ostream& out) { test_underflow<double>(out); },
+        [](std::ostream& out) { test_underflow<long double>(out); },
+
+        // wide integers
+        [](std::ostream& out) { test_underflow_signed<wide_int128>(out); },
+        [](std::ostream& out) { test_underflow_signed<wide_int256>(out); },
+        [](std::ostream& out) { test_underflow<wide_uint128>(out); },
+        [](std::ostream& out) { test_underflow<wide_uint256>(out); }
+    });
+}
+
+/*
+   The sweep harness checks add_numbers_checked and subtract_numbers_checked over
+   a grid of (start, increment, steps) per type against __int128 arithmetic, which
+   cannot overflow for any of the grid values. It is run with --sweep, which
+   exits with 1 when any case does not match.
+*/
+
+/// <summary>
+/// Start and increment values for the sweep: the values next to the limits and
+/// zero, where the checks are most likely to be wrong, plus repeatable random ones.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="count">How many values to generate</param>
+/// <returns>The generated values</returns>
+template <typename T>
+std::vector<T> make_sweep_values(std::size_t const& count)
+{
+    const T min = std::numeric_limits<T>::min();
+    const T max = std::numeric_limits<T>::max();
+
+    std::vector<T> values = { min, T(min + 1), T(min / 2), T(0), T(1), T(2), T(max / 5), T(max / 2), T(max - 1), max };
+    if constexpr (std::is_signed<T>::value)
+    {
+        values.push_back(T(-1));
+        values.push_back(T(-2));
+    }
+
+    std::mt19937_64 generator(405);
+    while (values.size() < count)
+    {
+        // mix full range values with small ones so both short and long runs are covered
+        const int shift = int(generator() % std::numeric_limits<T>::digits);
+        values.push_back(static_cast<T>(static_cast<T>(generator()) >> shift));
+    }
+    return values;
+}
+
+/// <summary>
+/// Step counts for the sweep. They stay below 2^40 so that increment * steps never
+/// leaves the range of the __int128 oracle.
+/// </summary>
+/// <param name="count">How many step counts to generate</param>
+/// <returns>The generated step counts</returns>
+std::vector<unsigned long int> make_sweep_steps(std::size_t const& count)
+{
+    std::vector<unsigned long int> steps = { 0, 1, 2, 5, 6, 127, 128, 255, 256, 65535, 65536 };
+
+    std::mt19937_64 generator(405);
+    while (steps.size() < count)
+    {
+        steps.push_back(static_cast<unsigned long int>(generator() >> (24 + generator() % 40)));
+    }
+    return steps;
+}
+
+#if defined(__SIZEOF_INT128__)
+/// <summary>
+/// Compares a checked result with the exact result computed by the oracle
+/// </summary>
+/// <returns>true when the value and the reported error are both right</returns>
+template <typename T>
+bool matches_oracle(checked_result<T> const& result, __int128 const& exact)
+{
+    const numeric_error expected = exact > std::numeric_limits<T>::max() ? numeric_error::overflow
+        : exact < std::numeric_limits<T>::min() ? numeric_error::underflow
+        : numeric_error::none;
+
+    // out of range results carry the wrapped value, which is the exact value mod 2^N
+    return result.error == expected && result.value == static_cast<T>(exact);
+}
+
+/// <summary>
+/// The totals of one or more sweeps
+/// </summary>
+struct sweep_totals
+{
+    std::uint64_t cases = 0;
+    std::uint64_t mismatches = 0;
+
+    sweep_totals& operator+=(sweep_totals const& other)
+    {
+        cases += other.cases;
+        mismatches += other.mismatches;
+        return *this;
+    }
+};
+
+/// <summary>
+/// Runs every combination of the sweep grid through add_numbers_checked and
+/// subtract_numbers_checked for T on all cores and reports the mismatches and
+/// the throughput.
+/// </summary>
+/// <param name="out">Where the report is written</param>
+/// <param name="grid_size">How many starts, increments and step counts to use</param>
+/// <returns>The number of cases checked and how many of them were wrong</returns>
+template <typename T>
+sweep_totals sweep_numbers(std::ostream& out, std::size_t const& grid_size)
+{
+    const std::vector<T> values = make_sweep_values<T>(grid_size);
+    const std::vector<unsigned long int> steps = make_sweep_steps(grid_size);
+
+    std::atomic<std::uint64_t> cases(0);
+    std::atomic<std::uint64_t> mismatches(0);
+
+    const auto begin = std::chrono::steady_clock::now();
+    parallel_for(values.size(), [&](std::size_t s) {
+        const T start = values[s];
+        std::uint64_t local_cases = 0;
+        std::uint64_t local_mismatches = 0;
+
+        for (const T increment : values)
+        {
+            for (const unsigned long int count : steps)
+            {
+                const __int128 delta = __int128(increment) * __int128(count);
+                local_mismatches += !matches_oracle(add_numbers_checked<T>(start, increment, count), __int128(start) + delta);
+                local_mismatches += !matches_oracle(subtract_numbers_checked<T>(start, increment, count), __int128(start) - delta);
+                local_cases += 2;
+            }
+        }
+        cases += local_cases;
+        mismatches += local_mismatches;
+    });
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    out << "Sweep of Type = " << typeid(T).name() << std::endl;
+    out << "\t" << cases << " cases, " << mismatches << " mismatches, " << (cases / seconds) << " cases/sec" << std::endl;
+    out << '\n';
+    return { cases, mismatches };
+}
+
+bool do_sweeps(const std::string& star_line)
+{
+    std::cout << std::endl << star_line << std::endl;
+    std::cout << "*** Running Sweeps ***" << std::endl;
+    std::cout << star_line << std::endl;
+
+    // 128 x 128 x 128 combinations of add and subtract, about four million cases per type
+    const std::size_t grid_size = 128;
+    sweep_totals totals;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    // signed integers
+    totals += sweep_numbers<char>(std::cout, grid_size);
+    totals += sweep_numbers<short int>(std::cout, grid_size);
+    totals += sweep_numbers<int>(std::cout, grid_size);
+    totals += sweep_numbers<long>(std::cout, grid_size);
+    totals += sweep_numbers<long long>(std::cout, grid_size);
+
+    // unsigned integers
+    totals += sweep_numbers<unsigned char>(std::cout, grid_size);
+    totals += sweep_numbers<wchar_t>(std::cout, grid_size);
+    totals += sweep_numbers<unsigned short int>(std::cout, grid_size);
+    totals += sweep_numbers<unsigned int>(std::cout, grid_size);
+    totals += sweep_numbers<unsigned long>(std::cout, grid_size);
+    totals += sweep_numbers<unsigned long long>(std::cout, grid_size);
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "All Sweeps: " << totals.cases << " cases, " << totals.mismatches << " mismatches, " << (totals.cases / seconds) << " cases/sec" << std::endl;
+    return totals.mismatches == 0;
+}
+#else
+bool do_sweeps(const std::string& star_line)
+{
+    std::cout << std::endl << star_line << std::endl;
+    std::cout << "The sweeps need a compiler with __int128 for the reference results." << std::endl;
+
+    // nothing was validated, which must not look like a pass
+    return false;
+}
+#endif
+
+/*
+   Functional checks for the kernels the printed tests and the static_asserts can
+   not reach: anything that depends on the floating-point environment, threads
+   or SIMD lanes only runs at run time. They are run with --check, which prints
+   every failed check and exits with 1 when there is one.
+*/
+
+/// <summary>
+/// Counts the checks and reports the ones that failed
+/// </summary>
+class check_log
+{
+public:
+    explicit check_log(std::ostream& out) : out(out) {}
+
+    /// <summary>
+    /// Records one check
+    /// </summary>
+    /// <param name="passed">Whether the check held</param>
+    /// <param name="description">What was checked, printed when it failed</param>
+    void expect(bool const& passed, std::string const& description)
+    {
+        ++checks;
+        if (!passed)
+        {
+            ++failures;
+            out << "\tFAILED: " << description << std::endl;
+        }
+    }
+
+    std::uint64_t check_count() const
+    {
+        return checks;
+    }
+
+    std::uint64_t failure_count() const
+    {
+        return failures;
+    }
+
+private:
+    std::ostream& out;
+    std::uint64_t checks = 0;
+    std::uint64_t failures = 0;
+};
+
+/// <summary>
+/// A list of types to run a check for each of
+/// </summary>
+template <typename... Types>
+struct type_list
+{
+    /// <summary>
+    /// Calls body with a std::type_identity of every type in the list
+    /// </summary>
+    template <typename Body>
+    static void for_each(Body const& body)
+    {
+        (body(std::type_identity<Types>{}), ...);
+    }
+};
+
+// the integer types of numeric_type, in the same order
+using checked_integer_types = type_list<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t>;
+
+#if defined(__SIZEOF_INT128__)
+/// <summary>
+/// The exact value of a Op b as a sign and a magnitude. Every sum and difference
+/// of two 64 bit operands fits __int128 and every product of their magnitudes
+/// fits unsigned __int128.
+/// </summary>
+template <mixed_operation Op, typename A, typename B>
+std::pair<bool, unsigned __int128> exact_mixed(A const& a, B const& b)
+{
+    if constexpr (Op == mixed_operation::multiply)
+    {
+        const unsigned __int128 magnitude = static_cast<unsigned __int128>(integral_magnitude(a)) * integral_magnitude(b);
+        return { magnitude != 0 && (a < 0) != (b < 0), magnitude };
+    }
+    else
+    {
+        const __int128 value = Op == mixed_operation::add ? __int128(a) + __int128(b) : __int128(a) - __int128(b);
+        return { value < 0, value < 0 ? static_cast<unsigned __int128>(-value) : static_cast<unsigned __int128>(value) };
+    }
+}
+
+/// <summary>
+/// Compares a checked result of type R with the exact value from exact_mixed
+/// </summary>
+/// <returns>true when the error is right and the value is the exact value modulo 2^N</returns>
+template <typename R>
+bool matches_exact(checked_result<R> const& result, std::pair<bool, unsigned __int128> const& exact)
+{
+    const unsigned __int128 limit = exact.first ? static_cast<unsigned __int128>(integral_magnitude(std::numeric_limits<R>::min()))
+        : static_cast<unsigned __int128>(std::numeric_limits<R>::max());
+    const numeric_error expected = exact.second <= limit ? numeric_error::none
+        : exact.first ? numeric_error::underflow : numeric_error::overflow;
+
+    // two's complement of the magnitude, whose low bits are the wrapped value
+    const unsigned __int128 bits = exact.first ? ~exact.second + 1 : exact.second;
+    return result.error == expected && result.value == static_cast<R>(static_cast<std::uint64_t>(bits));
+}
+
+/// <summary>
+/// Runs every pair of values through every strategy that can evaluate Op on A
+/// and B, not only the one mixed_arithmetic_checked selects
+/// </summary>
+/// <returns>The number of results that do not match the exact value</returns>
+template <mixed_operation Op, typename R, typename A, typename B>
+std::uint64_t mixed_mismatches(std::vector<A> const& as, std::vector<B> const& bs)
+{
+    constexpr mixed_strategy selected = mixed_strategy_for<Op, A, B>();
+    std::uint64_t mismatches = 0;
+
+    for (const A a : as)
+    {
+        for (const B b : bs)
+        {
+            const std::pair<bool, unsigned __int128> exact = exact_mixed<Op>(a, b);
+            mismatches += !matches_exact(mixed_arithmetic_checked<Op, R>(a, b), exact);
+            mismatches += !matches_exact(mixed_arithmetic_portable<Op, R>(a, b), exact);
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+            mismatches += !matches_exact(mixed_arithmetic_builtin<Op, R>(a, b), exact);
+#endif
+            // the promotions are only correct where the wide type holds every result
+            if constexpr (selected == mixed_strategy::promote_int64)
+            {
+                mismatches += !matches_exact(mixed_arithmetic_promoted<Op, R, std::int64_t>(a, b), exact);
+            }
+            if constexpr (selected <= mixed_strategy::promote_int128)
+            {
+                mismatches += !matches_exact(mixed_arithmetic_promoted<Op, R, __int128>(a, b), exact);
+            }
+        }
+    }
+    return mismatches;
+}
+
+/// <summary>
+/// checked_add, checked_subtract and checked_multiply: all 512 combinations of
+/// result and operand types, each through every strategy, against exact values
+/// </summary>
+void check_mixed_arithmetic(check_log& log)
+{
+    checked_integer_types::for_each([&](auto result_type) {
+        using R = typename decltype(result_type)::type;
+        checked_integer_types::for_each([&](auto left_type) {
+            using A = typename decltype(left_type)::type;
+            const std::vector<A> as = make_sweep_values<A>(16);
+            checked_integer_types::for_each([&](auto right_type) {
+                using B = typename decltype(right_type)::type;
+                const std::vector<B> bs = make_sweep_values<B>(16);
+
+                const std::string types = std::string(typeid(R).name()) + " from " + typeid(A).name() + ", " + typeid(B).name();
+                log.expect(mixed_mismatches<mixed_operation::add, R>(as, bs) == 0, "checked_add " + types);
+                log.expect(mixed_mismatches<mixed_operation::subtract, R>(as, bs) == 0, "checked_subtract " + types);
+                log.expect(mixed_mismatches<mixed_operation::multiply, R>(as, bs) == 0, "checked_multiply " + types);
+            });
+        });
+    });
+}
+#endif
+
+/// <summary>
+/// add_numbers_batch, including the AVX2 lanes when they are compiled in: the
+/// value and the failure bit of every lane against add_numbers
+/// </summary>
+template <typename T>
+void check_batch(check_log& log)
+{
+    // the limits and their neighbours, where the lanes fail, and random values in between
+    std::mt19937_64 generator(405);
+    std::vector<T> values = { std::numeric_limits<T>::min(), T(std::numeric_limits<T>::min() + 1), T(0), T(1), T(2),
+                              T(std::numeric_limits<T>::max() - 1), std::numeric_limits<T>::max() };
+    if constexpr (std::is_signed<T>::value)
+    {
+        values.push_back(T(-1));
+        values.push_back(T(-2));
+    }
+    while (values.size() < 32)
+    {
+        values.push_back(static_cast<T>(generator() >> (generator() % 64)));
+    }
+    const std::vector<unsigned long int> step_counts = { 0, 1, 2, 3, 7, 100, 65535, 65536, 4294967295ul, std::numeric_limits<unsigned long int>::max() };
+
+    // an odd number of lanes so the vector lanes and the scalar tail both run
+    const std::size_t lanes = 1027;
+    std::vector<T> starts(lanes);
+    std::vector<T> increments(lanes);
+    std::vector<unsigned long int> steps(lanes);
+    for (std::size_t i = 0; i < lanes; ++i)
+    {
+        starts[i] = values[i % values.size()];
+        increments[i] = values[(i / values.size()) % values.size()];
+        steps[i] = step_counts[(i * 7) % step_counts.size()];
+    }
+
+    std::vector<T> out(lanes);
+    std::vector<std::uint64_t> failed_lanes((lanes + 63) / 64);
+    const std::size_t failures = add_numbers_batch<T>(starts, increments, steps, out, failed_lanes);
+
+    std::size_t expected_failures = 0;
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < lanes; ++i)
+    {
+        // a failed lane reports its start
+        T expected = starts[i];
+        bool expected_failed = false;
+        try
+        {
+            expected = add_numbers<T>(starts[i], increments[i], steps[i]);
+        }
+        catch (const std::exception&)
+        {
+            expected_failed = true;
+        }
+        const bool failed = (failed_lanes[i / 64] >> (i % 64)) & 1;
+        expected_failures += expected_failed;
+        mismatches += failed != expected_failed || out[i] != expected;
+    }
+    log.expect(mismatches == 0 && failures == expected_failures, std::string(typeid(T).name()) + " add_numbers_batch lanes");
+}
+
+/// <summary>
+/// numeric_dispatch_engine: a shuffled stream of every type against
+/// add_numbers_record, with the batch contract of start for failed records
+/// </summary>
+void check_dispatch(check_log& log)
+{
+    std::vector<numeric_record> records;
+    std::size_t type_index = 0;
+    checked_integer_types::for_each([&](auto type) {
+        using T = typename decltype(type)::type;
+        const std::vector<T> values = make_sweep_values<T>(24);
+        const std::vector<unsigned long int> step_counts = make_sweep_steps(24);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            for (std::size_t j = 0; j < values.size(); ++j)
+            {
+                records.push_back({ static_cast<numeric_type>(type_index), static_cast<std::uint64_t>(values[i]),
+                                    static_cast<std::uint64_t>(values[j]), step_counts[(i + j) % step_counts.size()] });
+            }
+        }
+        ++type_index;
+    });
+
+    std::mt19937_64 generator(405);
+    std::shuffle(records.begin(), records.end(), generator);
+
+    std::vector<checked_result<std::uint64_t>> out(records.size());
+    numeric_dispatch_engine engine;
+    engine.run(records, out);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const checked_result<std::uint64_t> expected = add_numbers_record(records[i]);
+        // a failed record reports its start, which is the result of taking no steps
+        const std::uint64_t value = expected ? expected.value : add_numbers_record({ records[i].type, records[i].start, records[i].increment, 0 }).value;
+        mismatches += out[i].error != expected.error || out[i].value != value;
+    }
+    log.expect(mismatches == 0, "numeric_dispatch_engine records");
+}
+
+/// <summary>
+/// add_numbers_float_checked: overflow, underflow, absorption and non-finite inputs
+/// </summary>
+template <typename T>
+void check_float_mode(check_log& log)
+{
+    const std::string type = typeid(T).name();
+    const T max = std::numeric_limits<T>::max();
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+
+    const checked_result<T> in_range = add_numbers_float_checked<T>(0, T(0.5), 8);
+    log.expect(in_range.error == numeric_error::none && in_range.value == 4, type + " float mode in range");
+
+    const checked_result<T> overflow = add_numbers_float_checked<T>(0, max / 5, 6);
+    log.expect(overflow.error == numeric_error::overflow && std::isinf(overflow.value), type + " float mode overflow");
+
+    const checked_result<T> underflow = subtract_numbers_float_checked<T>(0, max / 5, 6);
+    log.expect(underflow.error == numeric_error::underflow && std::isinf(underflow.value), type + " float mode underflow");
+
+    // past 2^digits adding 1 rounds back to the same value
+    const T large = std::ldexp(T(1), std::numeric_limits<T>::digits + 1);
+    const checked_result<T> absorbed = add_numbers_float_checked<T>(large, 1, 10);
+    log.expect(absorbed.error == numeric_error::precision_loss && absorbed.value == large, type + " float mode absorption");
+
+    log.expect(add_numbers_float_checked<T>(inf, 1, 3).error == numeric_error::overflow, type + " float mode infinite start");
+    log.expect(add_numbers_float_checked<T>(-inf, 1, 3).error == numeric_error::underflow, type + " float mode negative infinite start");
+    log.expect(add_numbers_float_checked<T>(0, inf, 3).error == numeric_error::overflow, type + " float mode infinite increment");
+    log.expect(add_numbers_float_checked<T>(inf, 1, 0).error == numeric_error::overflow, type + " float mode infinite start without steps");
+    log.expect(add_numbers_float_checked<T>(1, inf, 0).error == numeric_error::none, type + " float mode infinite increment without steps");
+    log.expect(add_numbers_float_checked<T>(nan, 1, 3).error == numeric_error::precision_loss, type + " float mode NaN start");
+    log.expect(add_numbers_float_checked<T>(inf, -inf, 3).error == numeric_error::precision_loss, type + " float mode opposite infinities");
+
+    // the overflow inside the call must not leak into the caller's flags
+    std::feclearexcept(FE_OVERFLOW);
+    add_numbers_float_checked<T>(0, max / 5, 6);
+    log.expect(!std::fetestexcept(FE_OVERFLOW), type + " float mode keeps the caller's flags");
+}
+
+/// <summary>
+/// Real number sums that go below zero without leaving the range, through the
+/// per-step loop and the chunked path, under report_policy and saturate_policy
+/// </summary>
+template <typename T>
+void check_negative_real_sums(check_log& log)
+{
+    const std::string type = typeid(T).name();
+
+    const checked_result<T> added = add_numbers<T, report_policy>(T(0.25), T(-0.5), 3);
+    log.expect(added.error == numeric_error::none && added.value == T(-1.25), type + " add_numbers below zero");
+    log.expect(subtract_numbers<T, saturate_policy>(1, T(0.5), 3) == T(-0.5), type + " subtract_numbers below zero");
+
+    const checked_result<T> chunked = add_numbers_chunked<T, report_policy>(0, T(-0.5), 100000);
+    log.expect(chunked.error == numeric_error::none && chunked.value == T(-50000), type + " add_numbers_chunked below zero");
+    log.expect(subtract_numbers_chunked<T, saturate_policy>(1, T(0.5), 100000) == T(-49999), type + " subtract_numbers_chunked below zero");
+}
+
+/// <summary>
+/// add_numbers_compensated and add_numbers_pairwise: accuracy in range, and sums
+/// that overflow part way, where the compensation turns into NaN
+/// </summary>
+template <typename T>
+void check_accuracy_modes(check_log& log)
+{
+    const std::string type = typeid(T).name();
+    const T max = std::numeric_limits<T>::max();
+
+    const T exact = T(100000);
+    log.expect(std::abs(add_numbers_compensated<T>(0, T(0.1), 1000000) - exact) <= exact * std::numeric_limits<T>::epsilon(), type + " compensated in range");
+    log.expect(std::abs(add_numbers_pairwise<T>(0, T(0.1), 1000000) - exact) <= exact * 8 * std::numeric_limits<T>::epsilon(), type + " pairwise in range");
+
+    // fewer steps than lanes, and enough steps to go through the chunks
+    for (const unsigned long int steps : { 6ul, 100000ul })
+    {
+        const T increment = max / T(steps - 1);
+        const std::string run = " (" + std::to_string(steps) + " steps)";
+
+        const checked_result<T> compensated = add_numbers_compensated<T, report_policy>(0, increment, steps);
+        log.expect(compensated.error == numeric_error::overflow && compensated.value == std::numeric_limits<T>::infinity(), type + " compensated overflow" + run);
+        log.expect(add_numbers_compensated<T, report_policy>(0, -increment, steps).error == numeric_error::underflow, type + " compensated underflow" + run);
+        log.expect(add_numbers_pairwise<T, report_policy>(0, increment, steps).error == numeric_error::overflow, type + " pairwise overflow" + run);
+        log.expect(add_numbers_pairwise<T, report_policy>(0, -increment, steps).error == numeric_error::underflow, type + " pairwise underflow" + run);
+    }
+
+    log.expect(add_numbers_compensated<T, report_policy>(std::numeric_limits<T>::quiet_NaN(), 1, 10).error == numeric_error::precision_loss, type + " compensated NaN start");
+    log.expect(add_numbers_compensated<T, report_policy>(0, std::numeric_limits<T>::infinity(), 10).error == numeric_error::overflow, type + " compensated infinite increment");
+}
+
+/// <summary>
+/// atomic_checked_counter and sharded_checked_counter: the policies, the per-add
+/// limit of the shards, and concurrent adds that must land exactly
+/// </summary>
+void check_counters(check_log& log)
+{
+    using sharded = sharded_checked_counter<int, report_policy>;
+    const int max = std::numeric_limits<int>::max();
+
+    // a single add is limited to one slot, however far the total is from the limit
+    {
+        sharded counter;
+        log.expect(counter.add(sharded::max_increment()).error == numeric_error::none, "sharded counter takes max_increment");
+        const checked_result<int> too_large = sharded().add(sharded::max_increment() + 1);
+        log.expect(too_large.error == numeric_error::overflow && too_large.value == 0, "sharded counter rejects an add past max_increment");
+        log.expect(sharded().add(sharded::min_increment() - 1).error == numeric_error::underflow, "sharded counter rejects an add past min_increment");
+        log.expect(sharded_checked_counter<unsigned int, report_policy>().add(1).error == numeric_error::none, "sharded unsigned counter counts up");
+    }
+
+    // filling every slot gets within Shards * (increment + 1) of the limit and no further
+    {
+        sharded counter;
+        const int increment = 1000;
+        unsigned long int added = 0;
+        while (counter.add(increment))
+        {
+            ++added;
+        }
+        log.expect(counter.load() == int(added) * increment && counter.load() > max - 16 * (increment + 1), "sharded counter fills to the limit");
+    }
+
+    // the atomic counter takes any increment and leaves the value alone on failure
+    {
+        atomic_checked_counter<int, report_policy> counter(max - 5);
+        log.expect(counter.add(-200000000).value == max - 5 - 200000000, "atomic counter takes a large add");
+        atomic_checked_counter<int, report_policy> full(max - 5);
+        const checked_result<int> failed = full.add(6);
+        log.expect(failed.error == numeric_error::overflow && full.load() == max - 5, "atomic counter is unchanged after an overflow");
+        atomic_checked_counter<int, saturate_policy> clamped(max - 5);
+        log.expect(clamped.add(6) == max && clamped.load() == max, "atomic counter saturates");
+    }
+
+    // concurrent adds are neither lost nor allowed past the limit
+    {
+        const unsigned int threads = 4;
+        const int adds = 20000;
+        atomic_checked_counter<int, report_policy> exact;
+        sharded_checked_counter<int, report_policy> sharded_exact;
+        atomic_checked_counter<unsigned char, report_policy> small;
+        std::atomic<int> small_successes(0);
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&]() {
+                for (int i = 0; i < adds; ++i)
+                {
+                    exact.add(1);
+                    sharded_exact.add(1);
+                    small_successes += bool(small.add(1));
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        log.expect(exact.load() == int(threads) * adds, "atomic counter under contention");
+        log.expect(sharded_exact.load() == int(threads) * adds, "sharded counter under contention");
+        log.expect(small.load() == 255 && small_successes == 255, "atomic counter stops at the limit under contention");
+    }
+}
+
+/// <summary>
+/// numeric_telemetry: the counts of exited threads must survive the release of
+/// their tables and be merged with the live counts at the same site
+/// </summary>
+void check_telemetry(check_log& log)
+{
+    // a type no other code records with, so the site is this function's alone
+    struct telemetry_check_type {};
+    const std::source_location site = std::source_location::current();
+
+    auto site_count = [&site]() {
+        std::uint64_t overflows = 0;
+        for (auto& count : numeric_telemetry::snapshot().sites)
+        {
+            if (count.site.type == typeid(telemetry_check_type).name() && count.site.line == site.line())
+            {
+                overflows += count.events[static_cast<std::size_t>(numeric_error::overflow)];
+            }
+        }
+        return overflows;
+    };
+
+    for (int round = 0; round < 8; ++round)
+    {
+        std::thread([&site]() {
+            record_numeric_error<telemetry_check_type>(numeric_error::overflow, site);
+            record_numeric_error<telemetry_check_type>(numeric_error::overflow, site);
+        }).join();
+    }
+    log.expect(site_count() == 16, "telemetry keeps the counts of exited threads");
+
+    record_numeric_error<telemetry_check_type>(numeric_error::overflow, site);
+    log.expect(site_count() == 17, "telemetry merges live and exited counts");
+}
+
+/// <summary>
+/// safe_int with operands of other types, which must be checked as they are
+/// rather than narrowed to T first
+/// </summary>
+void check_safe_int(check_log& log)
+{
+    auto throws_overflow = [](auto const& operation) {
+        try
+        {
+            operation();
+        }
+        catch (std::overflow_error const&)
+        {
+            return true;
+        }
+        return false;
+    };
+    auto throws_underflow = [](auto const& operation) {
+        try
+        {
+            operation();
+        }
+        catch (std::underflow_error const&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    log.expect(throws_overflow([] { return safe_int<unsigned char, throw_policy>(0) + 256; }), "safe_int adds an operand wider than T");
+    log.expect(throws_overflow([] { return safe_int<unsigned char, throw_policy>(0) += 256; }), "safe_int += an operand wider than T");
+    log.expect(throws_overflow([] { return safe_int<unsigned char, throw_policy>(256); }), "safe_int converts an operand wider than T");
+    log.expect(throws_underflow([] { return safe_int<unsigned int, throw_policy>(1) * -1; }), "safe_int multiplies by a negative operand");
+    log.expect((safe_int<unsigned int, throw_policy>(5) - (-1)).value() == 6, "safe_int subtracts a negative operand");
+    log.expect((safe_int<unsigned int, throw_policy>(5) -= -1ll).value() == 6, "safe_int -= a negative operand");
+    log.expect((-7ll + safe_int<unsigned int, throw_policy>(9)).value() == 2, "safe_int adds to a wider operand");
+    log.expect(throws_underflow([] { return 3 - safe_int<unsigned int, throw_policy>(4); }), "safe_int subtracted from a narrower operand");
+
+    // same-type operations at the limits
+    log.expect(throws_overflow([] { return safe_int<long long, throw_policy>(std::numeric_limits<long long>::max()) + 1ll; }), "safe_int overflows at max");
+    log.expect(throws_underflow([] { return safe_int<long long, throw_policy>(std::numeric_limits<long long>::min()) - 1ll; }), "safe_int underflows at min");
+    log.expect(throws_underflow([] { return safe_int<unsigned long long, throw_policy>(0) - 1ull; }), "safe_int unsigned underflows at 0");
+}
+
+/// <summary>
+/// Runs every functional check
+/// </summary>
+/// <returns>true when every check passed</returns>
+bool do_checks(const std::string& star_line)
+{
+    std::cout << std::endl << star_line << std::endl;
+    std::cout << "*** Running Checks ***" << std::endl;
+    std::cout << star_line << std::endl;
+
+    check_log log(std::cout);
+
+    // batched lanes and the dispatch engine
+    checked_integer_types::for_each([&](auto type) { check_batch<typename decltype(type)::type>(log); });
+    check_dispatch(log);
+
+    // floating-point mode
+    check_float_mode<float>(log);
+    check_float_mode<double>(log);
+    check_float_mode<long double>(log);
+
+    // real number sums below zero
+    check_negative_real_sums<float>(log);
+    check_negative_real_sums<double>(log);
+    check_negative_real_sums<long double>(log);
+
+    // accuracy modes
+    check_accuracy_modes<float>(log);
+    check_accuracy_modes<double>(log);
+
+    // shared counters
+    check_counters(log);
+
+    // safe_int operands
+    check_safe_int(log);
+
+    // telemetry of exited threads
+    check_telemetry(log);
+
+    // mixed-type arithmetic
+#if defined(__SIZEOF_INT128__)
+    check_mixed_arithmetic(log);
+#else
+    std::cout << "\tThe mixed-type checks need a compiler with __int128 for the exact results." << std::endl;
+#endif
+
+    std::cout << "All Checks: " << log.check_count() << " checks, " << log.failure_count() << " failures" << std::endl;
+    return log.failure_count() == 0;
+}
+
+/*
+   Benchmarks are only run when the program is started with --bench so the
+   normal test output above stays unchanged.
+*/
+
+// results are written here so the optimizer cannot drop the timed calls
+volatile std::uintmax_t benchmark_sink = 0;
+
+/// <summary>
+/// The bits of a kernel result to add to the sink. Real numbers are copied byte
+/// for byte, because converting a negative or huge real number to an unsigned
+/// integer is undefined.
+/// </summary>
+template <typename T>
+std::uintmax_t sink_bits(T const& value)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        std::uintmax_t bits = 0;
+        std::memcpy(&bits, &value, std::min(sizeof(bits), sizeof(value)));
+        return bits;
+    }
+    else
+    {
+        return static_cast<std::uintmax_t>(value);
+    }
+}
+
+/// <summary>
+/// One set of arguments for a timed add_numbers style call
+/// </summary>
+template <typename T>
+struct benchmark_input
+{
+    T start;
+    T increment;
+    unsigned long int steps;
+};
+
+/// <summary>
+/// Builds a repeatable set of random inputs where roughly failing_percent of them
+/// overflow or underflow and the rest stay within the limits of T. With the default
+/// of 0 the timings measure the checks and not the failure handling.
+/// </summary>
+/// <typeparam name="T">An integral type</typeparam>
+/// <param name="count">How many inputs to generate</param>
+/// <param name="failing_percent">How many of the inputs should fail, from 0 to 100</param>
+/// <returns>The generated inputs</returns>
+template <typename T>
+std::vector<benchmark_input<T>> make_benchmark_inputs(std::size_t const& count, unsigned int const& failing_percent = 0)
+{
+    std::mt19937_64 generator(405);
+    std::vector<benchmark_input<T>> inputs;
+    inputs.reserve(count);
+
+    const std::size_t failing = count * failing_percent / 100;
+    std::size_t failed = 0;
+
+    while (inputs.size() < count)
+    {
+        benchmark_input<T> input = {
+            static_cast<T>(generator()),
+            static_cast<T>(generator() >> (64 - std::numeric_limits<T>::digits / 2)),
+            static_cast<unsigned long int>(generator() % 1000)
+        };
+
+        // random starts almost never fail for wide types, so aim some at the limit
+        if (failed < failing && generator() % 2 == 0)
+        {
+            input.start = input.increment < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+
+        const bool fails = !add_numbers_checked<T>(input.start, input.increment, input.steps);
+        if (fails && failed < failing)
+        {
+            inputs.push_back(input);
+            ++failed;
+        }
+        else if (!fails && inputs.size() - failed < count - failing)
+        {
+            inputs.push_back(input);
+        }
+    }
+    return inputs;
+}
+
+/// <summary>
+/// Converts long long inputs to a wide integer type W, whose full range random
+/// inputs would almost never be near a limit
+/// </summary>
+/// <param name="inputs">long long inputs that do not overflow</param>
+/// <returns>The same inputs in W</returns>
+template <typename W>
+std::vector<benchmark_input<W>> widen_benchmark_inputs(std::vector<benchmark_input<long long>> const& inputs)
+{
+    std::vector<benchmark_input<W>> wide_inputs;
+    for (auto& input : inputs)
+    {
+        wide_inputs.push_back({ W(input.start), W(input.increment), input.steps });
+    }
+    return wide_inputs;
+}
+
+/// <summary>
+/// Calls kernel once for every input, repeats times, and reports the average cost
+/// </summary>
+/// <param name="inputs">The arguments to call kernel with</param>
+/// <param name="repeats">How many passes to make over the inputs</param>
+/// <param name="kernel">The function being timed</param>
+/// <returns>Average nanoseconds per call</returns>
+template <typename T, typename Kernel>
+double time_per_call(std::vector<benchmark_input<T>> const& inputs, unsigned int const& repeats, Kernel kernel)
+{
+    std::uintmax_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (unsigned int r = 0; r < repeats; ++r)
+    {
+        for (auto& input : inputs)
+        {
+            sink += sink_bits(kernel(input));
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    benchmark_sink = benchmark_sink + sink;
+
+    const double calls = double(inputs.size()) * repeats;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / calls;
+}
+
+/// <summary>
+/// Compares the portable limit checks against the compiler builtin checks for T
+/// </summary>
+template <typename T>
+void benchmark_checked_backends()
+{
+    const std::vector<benchmark_input<T>> inputs = make_benchmark_inputs<T>(1 << 16);
+    const unsigned int repeats = 64;
+
+    std::cout << "Checked Backends of Type = " << typeid(T).name() << std::endl;
+
+    const double portable = time_per_call(inputs, repeats, [](benchmark_input<T> const& in) {
+        return integral_multiply_accumulate_portable<T>(in.start, integral_magnitude(in.increment), !(in.increment < 0), in.steps).value;
+    });
+    std::cout << "\tportable: " << portable << " ns/call" << std::endl;
+
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    const double builtin = time_per_call(inputs, repeats, [](benchmark_input<T> const& in) {
+        return integral_multiply_accumulate_builtin<T>(in.start, integral_magnitude(in.increment), !(in.increment < 0), in.steps).value;
+    });
+    std::cout << "\tbuiltin:  " << builtin << " ns/call" << std::endl;
+#else
+    std::cout << "\tbuiltin:  not available with this compiler" << std::endl;
+#endif
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Compares an unchecked count * size against the checked multiply backends on
+/// allocation sized operands that fit in std::size_t
+/// </summary>
+void benchmark_size_computations()
+{
+    std::mt19937_64 generator(405);
+    std::vector<benchmark_input<std::size_t>> inputs;
+    for (std::size_t i = 0; i < (1 << 16); ++i)
+    {
+        const std::size_t count = static_cast<std::size_t>(generator() >> (64 - std::numeric_limits<std::size_t>::digits / 2 + 1));
+        const std::size_t size = static_cast<std::size_t>(generator() % 4096) + 1;
+        inputs.push_back({ count, size, 1 });
+    }
+    const unsigned int repeats = 64;
+
+    std::cout << "Size Computations" << std::endl;
+
+    const double unchecked = time_per_call(inputs, repeats, [](benchmark_input<std::size_t> const& in) {
+        return in.start * in.increment;
+    });
+    std::cout << "\tunchecked: " << unchecked << " ns/call" << std::endl;
+
+    const double portable = time_per_call(inputs, repeats, [](benchmark_input<std::size_t> const& in) {
+        return integral_multiply_portable<std::size_t>(in.start, in.increment).value;
+    });
+    std::cout << "\tportable:  " << portable << " ns/call" << std::endl;
+
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+    const double builtin = time_per_call(inputs, repeats, [](benchmark_input<std::size_t> const& in) {
+        return integral_multiply_builtin<std::size_t>(in.start, in.increment).value;
+    });
+    std::cout << "\tbuiltin:   " << builtin << " ns/call" << std::endl;
+#else
+    std::cout << "\tbuiltin:   not available with this compiler" << std::endl;
+#endif
+
+    const double policy = time_per_call(inputs, repeats, [](benchmark_input<std::size_t> const& in) {
+        return multiply_numbers<std::size_t>(in.start, in.increment, in.steps);
+    });
+    std::cout << "\tmultiply_numbers: " << policy << " ns/call" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Sums the same values with plain T, safe_int with the checks and safe_int with
+/// unchecked_policy, which shows the exact cost of the checks and that the
+/// unchecked safe_int compiles to the plain loop
+/// </summary>
+template <typename T>
+void benchmark_safe_int()
+{
+    const std::size_t count = 1 << 16;
+    const unsigned int repeats = 64;
+
+    // small enough that the sum of all of them fits in T
+    std::mt19937_64 generator(405);
+    std::vector<T> values(count);
+    for (auto& value : values)
+    {
+        value = static_cast<T>(generator() % (std::numeric_limits<T>::max() / count));
+    }
+
+    auto time_sum = [&](auto zero) {
+        std::uintmax_t sink = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        for (unsigned int r = 0; r < repeats; ++r)
+        {
+            auto total = zero;
+            for (auto& value : values)
+            {
+                total += value;
+            }
+            sink += static_cast<std::uintmax_t>(static_cast<T>(total));
+        }
+        const auto end = std::chrono::steady_clock::now();
+        benchmark_sink = benchmark_sink + sink;
+        return std::chrono::duration<double, std::nano>(end - begin).count() / (double(count) * repeats);
+    };
+
+    std::cout << "safe_int of Type = " << typeid(T).name() << std::endl;
+    const double plain = time_sum(T(0));
+    const double checked = time_sum(safe_int<T, throw_policy>(0));
+    const double unchecked = time_sum(safe_int<T, unchecked_policy>(0));
+    std::cout << "\tplain:     " << plain << " ns/add" << std::endl;
+    std::cout << "\tchecked:   " << checked << " ns/add (" << checked / plain << "x)" << std::endl;
+    std::cout << "\tunchecked: " << unchecked << " ns/add (" << unchecked / plain << "x)" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Compares calling add_numbers once per lane against add_numbers_batch for T
+/// </summary>
+template <typename T>
+void benchmark_batch()
+{
+    const std::vector<benchmark_input<T>> inputs = make_benchmark_inputs<T>(1 << 16);
+    const unsigned int repeats = 64;
+
+    std::vector<T> starts, increments, out(inputs.size());
+    std::vector<unsigned long int> steps;
+    std::vector<std::uint64_t> failed_lanes((inputs.size() + 63) / 64);
+    for (auto& input : inputs)
+    {
+        starts.push_back(input.start);
+        increments.push_back(input.increment);
+        steps.push_back(input.steps);
+    }
+
+    std::cout << "Batch Addition of Type = " << typeid(T).name() << std::endl;
+
+    const double scalar = time_per_call(inputs, repeats, [](benchmark_input<T> const& in) {
+        return add_numbers<T>(in.start, in.increment, in.steps);
+    });
+    std::cout << "\tscalar: " << scalar << " ns/lane" << std::endl;
+
+    std::uintmax_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repeats; ++r)
+    {
+        sink += add_numbers_batch<T>(starts, increments, steps, out, failed_lanes);
+        sink += static_cast<std::uintmax_t>(out[r % out.size()]);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    benchmark_sink = benchmark_sink + sink;
+
+    const double batch = std::chrono::duration<double, std::nano>(end - begin).count() / (double(inputs.size()) * repeats);
+    std::cout << "\tbatch:  " << batch << " ns/lane" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Compares catching the exceptions from add_numbers against testing the result of
+/// add_numbers_checked when half of the inputs overflow or underflow
+/// </summary>
+template <typename T>
+void benchmark_error_reporting()
+{
+    const std::vector<benchmark_input<T>> inputs = make_benchmark_inputs<T>(1 << 14, 50);
+    const unsigned int repeats = 16;
+
+    std::cout << "Error Reporting of Type = " << typeid(T).name() << std::endl;
+
+    const double throwing = time_per_call(inputs, repeats, [](benchmark_input<T> const& in) {
+        try
+        {
+            return add_numbers<T>(in.start, in.increment, in.steps);
+        }
+        catch (const std::exception&)
+        {
+            return T(0);
+        }
+    });
+    std::cout << "\tthrowing: " << throwing << " ns/call" << std::endl;
+
+    const double checked = time_per_call(inputs, repeats, [](benchmark_input<T> const& in) {
+        const checked_result<T> result = add_numbers_checked<T>(in.start, in.increment, in.steps);
+        return result ? result.value : T(0);
+    });
+    std::cout << "\tchecked:  " << checked << " ns/call" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Compares counting failures with the telemetry against writing the exception
+/// message to a stream, on inputs where every call fails. The stream is an
+/// ostringstream, so a real console would only be slower.
+/// </summary>
+void benchmark_telemetry()
+{
+    const std::vector<benchmark_input<int>> inputs = make_benchmark_inputs<int>(1 << 14, 100);
+    const unsigned int repeats = 16;
+
+    std::cout << "Error Telemetry" << std::endl;
+
+    std::ostringstream log;
+    const double printed = time_per_call(inputs, repeats, [&log](benchmark_input<int> const& in) {
+        const checked_result<int> result = add_numbers_checked<int>(in.start, in.increment, in.steps);
+        if (!result)
+        {
+            log << (result.error == numeric_error::overflow ? "ERROR: Numeric overflow has occured!" : "ERROR: Numeric underflow has occured!") << '\n';
+        }
+        return result.value;
+    });
+    std::cout << "\tprinted: " << printed << " ns/call" << std::endl;
+
+    const double counted = time_per_call(inputs, repeats, [](benchmark_input<int> const& in) {
+        return count_numeric_errors(add_numbers_checked<int>(in.start, in.increment, in.steps)).value;
+    });
+    std::cout << "\tcounted: " << counted << " ns/call" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Times add_numbers for a wide integer type W on the same inputs as long long
+/// </summary>
+/// <param name="inputs">long long inputs that do not overflow</param>
+/// <param name="repeats">How many passes to make over the inputs</param>
+/// <returns>Average nanoseconds per call</returns>
+template <typename W>
+double time_wide_add_numbers(std::vector<benchmark_input<long long>> const& inputs, unsigned int const& repeats)
+{
+    return time_per_call(widen_benchmark_inputs<W>(inputs), repeats, [](benchmark_input<W> const& in) {
+        return add_numbers<W>(in.start, in.increment, in.steps);
+    });
+}
+
+/// <summary>
+/// Compares add_numbers on long long against the wide integer types
+/// </summary>
+void benchmark_wide_integers()
+{
+    const std::vector<benchmark_input<long long>> inputs = make_benchmark_inputs<long long>(1 << 16);
+    const unsigned int repeats = 64;
+
+    std::cout << "Wide Integers" << std::endl;
+
+    const double narrow = time_per_call(inputs, repeats, [](benchmark_input<long long> const& in) {
+        return add_numbers<long long>(in.start, in.increment, in.steps);
+    });
+    std::cout << "\tlong long:    " << narrow << " ns/call" << std::endl;
+    std::cout << "\twide_int128:  " << time_wide_add_numbers<wide_int128>(inputs, repeats) << " ns/call" << std::endl;
+    std::cout << "\twide_uint128: " << time_wide_add_numbers<wide_uint128>(inputs, repeats) << " ns/call" << std::endl;
+    std::cout << "\twide_int256:  " << time_wide_add_numbers<wide_int256>(inputs, repeats) << " ns/call" << std::endl;
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Compares the per-step limit checks of add_numbers against add_numbers_chunked,
+/// which checks once per safe block, for one long run. Both give the same value.
+/// </summary>
+template <typename T>
+void benchmark_chunked_mode()
+{
+    const unsigned long int steps = 100000000;
+    const T increment = T(0.5);
+
+    std::cout << "Chunked Mode of Type = " << typeid(T).name() << std::endl;
 
-    std::cout << "Overflow Test of Type = " << typeid(T).name() << std::endl;
-    // END DO NOT CHANGE
+    auto begin = std::chrono::steady_clock::now();
+    volatile T checked = add_numbers<T>(T(0), increment, steps);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "\tper-step checks:  " << std::chrono::duration<double, std::nano>(end - begin).count() / steps << " ns/step" << std::endl;
 
+    begin = std::chrono::steady_clock::now();
+    volatile T chunked = add_numbers_chunked<T>(T(0), increment, steps);
+    end = std::chrono::steady_clock::now();
+    std::cout << "\tper-block checks: " << std::chrono::duration<double, std::nano>(end - begin).count() / steps << " ns/step"
+              << (checked == chunked ? "" : " (results differ!)") << std::endl;
+    std::cout << '\n';
+}
 
-    /*
-    * -------------------------CHANGES-----------------------------------------------
-        Try to add the numbers and catch an overflow, underflow, or unkown exception
-        and handle it by printing an error message to the console
-     --------------------------------------------------------------------------------
-    */
+/// <summary>
+/// Compares the per-step limit checks of add_numbers against the blocked
+/// floating-point mode of add_numbers_float for one long run
+/// </summary>
+template <typename T>
+void benchmark_float_mode()
+{
+    const unsigned long int steps = 10000000;
+    const T increment = T(0.5);
 
-    // No overflow test
-    T result;
-    std::cout << "\tAdding Numbers Without Overflow (" << +start << ", " << +increment << ", " << steps << ") = ";
+    std::cout << "Floating-Point Mode of Type = " << typeid(T).name() << std::endl;
 
-    try
-    {
-        result = add_numbers<T>(start, increment, steps); // Attempt to add the numbers
-        std::cout << +result << '\n'; // Display the result of the addition
-    }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
-    {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
-    }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
-    {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
-    }
-    catch (const std::exception& e)
-    {
-        std::cout << "ERROR Unknown Addition Error " << e.what() << '\n';
-    }
+    auto begin = std::chrono::steady_clock::now();
+    volatile T checked = add_numbers<T>(T(0), increment, steps);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "\tper-step checks: " << std::chrono::duration<double, std::nano>(end - begin).count() / steps << " ns/step" << std::endl;
 
-    // Overflow test
-    std::cout << "\tAdding Numbers With Overflow (" << +start << ", " << +increment << ", " << (steps + 1) << ") = ";
+    begin = std::chrono::steady_clock::now();
+    volatile T blocked = add_numbers_float<T, wrap_policy>(T(0), increment, steps);
+    end = std::chrono::steady_clock::now();
+    std::cout << "\tblocked flags:   " << std::chrono::duration<double, std::nano>(end - begin).count() / steps << " ns/step" << std::endl;
 
-    try
-    {
-        result = add_numbers<T>(start, increment, steps + 1); // Attempt to add the numbers
-        std::cout << +result; // Display the result of the addition
-    }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
-    {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
-    }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
-    {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
-    }
-    catch (const std::exception& e)
-    {
-        std::cout << "ERROR Unknown Addition Error " << e.what() << '\n';
-    }
+    (void)checked;
+    (void)blocked;
     std::cout << '\n';
 }
 
+/// <summary>
+/// Compares the plain, compensated and pairwise real number sums of 0.1 for step
+/// counts from 10^3 to 10^9, reporting throughput and the relative error against a
+/// long double reference. Where long double is the same as double (MSVC) the
+/// reference is no more accurate than the sums it checks.
+/// </summary>
 template <typename T>
-void test_underflow()
+void benchmark_accuracy_modes()
 {
-    // TODO: The subtract_numbers template function will underflow in the second method call
-    //        You need to change the subtract_numbers method to:
-    //        1. Detect when an underflow will happen
-    //        2. Prevent it from happening
-    //        3. Return the correct value when no underflow happened or
-    //        4. Return something to tell test_underflow the subtraction failed
-    //        NOTE: The subtract_numbers method must remain a template in the NumericFunctions header.
-    //
-    //        You need to change the test_underflow method to:
-    //        1. Detect when an subtract_numbers failed
-    //        2. Inform the user the underflow happened
-    //        3. A successful result displays the same result as before you changed the method
-    //        NOTE: You cannot change anything between START / END DO NOT CHANGE
-    //              The test_underflow method must remain a template in the NumericOverflows source file
-    //
-    //  There are more than one possible solution to this problem. 
-    //  The solution must work for all of the data types used to call test_overflow() in main().
+    const T increment = T(0.1);
 
-    // START DO NOT CHANGE
-    //  how many times will we iterate
-    const unsigned long int steps = 5;
-    // how much will we subtract each step (result should be: start - (increment * steps))
-    const T decrement = std::numeric_limits<T>::max() / steps;
-    // whats our starting point
-    const T start = std::numeric_limits<T>::max();
+    std::cout << "Accuracy Modes of Type = " << typeid(T).name() << std::endl;
 
-    std::cout << "Underflow Test of Type = " << typeid(T).name() << std::endl;
-    // END DO NOT CHANGE
+    for (unsigned long int steps = 1000; steps <= 1000000000ul && steps > 0; steps *= 10)
+    {
+        const long double reference = static_cast<long double>(increment) * steps;
 
-    /*
-    * -------------------------CHANGES---------------------------------------------------
-        Try to subtract the numbers and catch an overflow, underflow, or unkown exception
-        and handle it by printing an error message to the console
-     ------------------------------------------------------------------------------------
-    */
+        auto report = [&](const char* name, auto sum_numbers) {
+            const auto begin = std::chrono::steady_clock::now();
+            const T sum = sum_numbers();
+            const auto end = std::chrono::steady_clock::now();
 
-    // No underflow test
-    T result;
-    std::cout << "\tSubtracting Numbers Without Overflow (" << +start << ", " << +decrement << ", " << steps << ") = ";
-    try
+            const double seconds = std::chrono::duration<double>(end - begin).count();
+            const long double error = std::abs((static_cast<long double>(sum) - reference) / reference);
+            std::cout << "\t" << name << " steps=" << steps << ": " << (steps / seconds) << " steps/sec, relative error " << double(error) << std::endl;
+        };
+
+        report("plain      ", [&]() { return add_numbers<T, wrap_policy>(T(0), increment, steps); });
+        report("compensated", [&]() { return add_numbers_compensated<T, wrap_policy>(T(0), increment, steps); });
+        report("pairwise   ", [&]() { return add_numbers_pairwise<T, wrap_policy>(T(0), increment, steps); });
+    }
+    std::cout << '\n';
+}
+
+/// <summary>
+/// Has every thread add one to counter adds times and returns the wall time per add
+/// </summary>
+/// <param name="counter">The counter being timed, starting at 0</param>
+/// <param name="threads">How many threads add at the same time</param>
+/// <param name="adds">How many adds each thread makes</param>
+/// <returns>Nanoseconds per add, or a negative number if the final count is wrong</returns>
+template <typename Counter>
+double time_counter(Counter& counter, unsigned int const& threads, unsigned long int const& adds)
+{
+    std::atomic<unsigned int> ready(0);
+    std::vector<std::thread> workers;
+
+    auto worker = [&]() {
+        // start together so the threads actually contend
+        ++ready;
+        while (ready.load() < threads)
+        {
+            std::this_thread::yield();
+        }
+        for (unsigned long int i = 0; i < adds; ++i)
+        {
+            counter.add(1);
+        }
+    };
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threads; ++t)
     {
-        result = subtract_numbers<T>(start, decrement, steps); // Attempt to subtract the numbers
-        std::cout << +result << '\n'; // Display the result of the subtraction
+        workers.emplace_back(worker);
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    for (auto& thread : workers)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        thread.join();
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    const auto end = std::chrono::steady_clock::now();
+
+    const double total = double(threads) * adds;
+    if (double(counter.load()) != total)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        return -1;
     }
-    catch (const std::exception& e)
+    return std::chrono::duration<double, std::nano>(end - begin).count() / total;
+}
+
+/// <summary>
+/// Compares an unchecked std::atomic fetch_add against atomic_checked_counter and
+/// sharded_checked_counter from 1 to 64 threads all adding to the same counter
+/// </summary>
+void benchmark_atomic_counters()
+{
+    // a plain atomic with the same add and load as the counters for the baseline
+    struct unchecked_counter
     {
-        std::cout << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+        std::atomic<unsigned long long> value{ 0 };
+        void add(unsigned long long const& increment) { value.fetch_add(increment, std::memory_order_relaxed); }
+        unsigned long long load() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    const unsigned long int adds = 1 << 17;
+
+    std::cout << "Atomic Counters (ns/add)" << std::endl;
+    for (unsigned int threads = 1; threads <= 64; threads *= 2)
+    {
+        unchecked_counter unchecked;
+        atomic_checked_counter<unsigned long long> checked;
+        sharded_checked_counter<unsigned long long> sharded;
+
+        std::cout << "\t" << threads << " threads: unchecked " << time_counter(unchecked, threads, adds)
+                  << ", checked " << time_counter(checked, threads, adds)
+                  << ", sharded " << time_counter(sharded, threads, adds) << std::endl;
     }
+    std::cout << '\n';
+}
 
-    // Underflow test
-    std::cout << "\tSubtracting Numbers With Overflow (" << +start << ", " << +decrement << ", " << (steps + 1) << ") = ";
-    try
+/// <summary>
+/// Compares switching on the type of every record against numeric_dispatch_engine
+/// on a stream with the types shuffled together, and reports the engine's
+/// throughput for each type
+/// </summary>
+void benchmark_dispatch()
+{
+    std::mt19937_64 generator(405);
+    std::vector<numeric_record> records(1 << 18);
+    for (auto& record : records)
     {
-        result = subtract_numbers<T>(start, decrement, steps + 1); // Attempt to subtract the numbers
-        std::cout << +result << '\n'; // Display the result of the subtraction
+        // values that fit the record's type, sign extended to 64 bits
+        const unsigned int bits = 8u << (generator() % 4);
+        const std::uint64_t start = generator();
+        const std::uint64_t increment = generator() >> (64 - bits / 2);
+        record.type = static_cast<numeric_type>(std::countr_zero(bits / 8) * 2 + generator() % 2);
+        record.start = bits == 64 ? start : std::uint64_t(std::int64_t(start << (64 - bits)) >> (64 - bits));
+        record.increment = increment;
+        record.steps = static_cast<unsigned long int>(generator() % 1000);
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+    std::vector<checked_result<std::uint64_t>> out(records.size());
+    const unsigned int repeats = 16;
+
+    std::cout << "Runtime Dispatch (Mrecords/s)" << std::endl;
+
+    std::uintmax_t sink = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repeats; ++r)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        for (auto& record : records)
+        {
+            sink += add_numbers_record(record).value;
+        }
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    auto end = std::chrono::steady_clock::now();
+    benchmark_sink = benchmark_sink + sink;
+    const double per_record = double(records.size()) * repeats * 1000.0 / std::chrono::duration<double, std::nano>(end - begin).count();
+    std::cout << "\tswitch per record: " << per_record << std::endl;
+
+    numeric_dispatch_engine engine;
+    std::array<numeric_dispatch_stats, numeric_type_count> totals = {};
+    begin = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repeats; ++r)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        auto& stats = engine.run(records, out);
+        for (std::size_t t = 0; t < numeric_type_count; ++t)
+        {
+            totals[t].records += stats[t].records;
+            totals[t].failures += stats[t].failures;
+            totals[t].nanoseconds += stats[t].nanoseconds;
+        }
     }
-    catch (const std::exception& e)
+    end = std::chrono::steady_clock::now();
+    const double grouped = double(records.size()) * repeats * 1000.0 / std::chrono::duration<double, std::nano>(end - begin).count();
+    std::cout << "\tdispatch engine:   " << grouped << std::endl;
+
+    for (std::size_t t = 0; t < numeric_type_count; ++t)
     {
-        std::cout << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+        std::cout << "\t\t" << numeric_type_name(static_cast<numeric_type>(t)) << ": " << totals[t].throughput()
+                  << " (" << totals[t].records / repeats << " records, " << totals[t].failures / repeats << " failed)" << std::endl;
     }
     std::cout << '\n';
 }
 
 /*
-   -------------------------CHANGES---------------------------------------------------
-      Added a new template method specifically for testing signed integer underflow.
-      Starts at MIN + 5 and decrements by 1 until steps or steps + 1.
-   -----------------------------------------------------------------------------------
+   The kernel suite times every type from do_overflow_tests with each way of
+   calling the kernels and keeps the numbers as records, so they can be written
+   as CSV or JSON and compared between builds:
+       Module1NumericOverflow --bench --csv
+       Module1NumericOverflow --bench --json
 */
-template <typename T>
-void test_underflow_signed()
-{
-    //  how many times will we iterate
-    const unsigned long int steps = 5;
-    // how much will we subtract each step (result should be: start - (increment * steps))
-    const T decrement = 1;
-    // whats our starting point
-    const T start = std::numeric_limits<T>::min() + 5;
 
-    std::cout << "Underflow Test of Type = " << typeid(T).name() << std::endl;
- 
-    /*
-    * -------------------------CHANGES---------------------------------------------------
-        Try to subtract the numbers and catch an overflow, underflow, or unkown exception
-        and handle it by printing an error message to the console
-     ------------------------------------------------------------------------------------
-    */
+/// <summary>
+/// One measurement of the kernel suite
+/// </summary>
+struct benchmark_record
+{
+    std::string type;
+    std::string variant;
+    double ns_per_call;
+    double ns_per_step;
+};
 
-    // No underflow test
-    T result;
-    std::cout << "\tSubtracting Numbers Without Overflow (" << +start << ", " << +decrement << ", " << steps << ") = ";
-    try
+/// <summary>
+/// Times one way of calling the kernels for T and adds the result to records
+/// </summary>
+/// <param name="records">Where the measurement is added</param>
+/// <param name="type">The name of T for the report</param>
+/// <param name="variant">The name of the way the kernels are called</param>
+/// <param name="inputs">The arguments to call kernel with</param>
+/// <param name="kernel">The function being timed</param>
+template <typename T, typename Kernel>
+void record_kernel(std::vector<benchmark_record>& records, std::string const& type, std::string const& variant,
+                   std::vector<benchmark_input<T>> const& inputs, Kernel kernel)
+{
+    double steps = 0;
+    for (auto& input : inputs)
     {
-        result = subtract_numbers<T>(start, decrement, steps); // Attempt to subtract the numbers
-        std::cout << +result << '\n'; // Display the result of the subtraction
+        steps += input.steps;
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+
+    const double ns_per_call = time_per_call(inputs, 16, kernel);
+    records.push_back({ type, variant, ns_per_call, ns_per_call / (steps / inputs.size()) });
+}
+
+/// <summary>
+/// Times the throwing, non-throwing and backend specific kernels for T
+/// </summary>
+/// <param name="records">Where the measurements are added</param>
+/// <param name="type">The name of T for the report</param>
+template <typename T>
+void suite_kernels(std::vector<benchmark_record>& records, std::string const& type)
+{
+    std::vector<benchmark_input<T>> inputs;
+    if constexpr (is_wide_integer<T>::value)
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        // the same inputs benchmark_wide_integers uses, so the rows compare with long long
+        inputs = widen_benchmark_inputs<T>(make_benchmark_inputs<long long>(1 << 14));
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    else
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        inputs = make_benchmark_inputs<T>(1 << 14);
     }
-    catch (const std::exception& e)
+
+    record_kernel(records, type, "throwing", inputs, [](benchmark_input<T> const& in) {
+        return add_numbers<T>(in.start, in.increment, in.steps);
+    });
+    record_kernel(records, type, "checked", inputs, [](benchmark_input<T> const& in) {
+        return add_numbers_checked<T>(in.start, in.increment, in.steps).value;
+    });
+
+    if constexpr (std::is_integral<T>::value)
     {
-        std::cout << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+        record_kernel(records, type, "portable", inputs, [](benchmark_input<T> const& in) {
+            return integral_multiply_accumulate_portable<T>(in.start, integral_magnitude(in.increment), !(in.increment < 0), in.steps).value;
+        });
+#if NUMERIC_OVERFLOW_USE_BUILTINS
+        record_kernel(records, type, "builtin", inputs, [](benchmark_input<T> const& in) {
+            return integral_multiply_accumulate_builtin<T>(in.start, integral_magnitude(in.increment), !(in.increment < 0), in.steps).value;
+        });
+#endif
     }
-
-    // Underflow test
-    std::cout << "\tSubtracting Numbers With Overflow (" << +start << ", " << +decrement << ", " << (steps + 1) << ") = ";
-    try
+    else if constexpr (std::is_floating_point<T>::value)
     {
-        result = subtract_numbers<T>(start, decrement, steps + 1); // Attempt to subtract the numbers
-        std::cout << +result << '\n'; // Display the result of the subtraction
+        record_kernel(records, type, "float_mode", inputs, [](benchmark_input<T> const& in) {
+            return add_numbers_float_checked<T>(in.start, in.increment, in.steps).value;
+        });
     }
-    catch (const std::overflow_error& e) // Catch the thrown exeption if an overflow occurs
+}
+
+/// <summary>
+/// Runs the kernel suite over every type used in do_overflow_tests
+/// </summary>
+/// <returns>One record per type and variant</returns>
+std::vector<benchmark_record> run_kernel_suite()
+{
+    std::vector<benchmark_record> records;
+
+    // signed integers
+    suite_kernels<char>(records, "char");
+    suite_kernels<short int>(records, "short int");
+    suite_kernels<int>(records, "int");
+    suite_kernels<long>(records, "long");
+    suite_kernels<long long>(records, "long long");
+
+    // unsigned integers
+    suite_kernels<unsigned char>(records, "unsigned char");
+    suite_kernels<wchar_t>(records, "wchar_t");
+    suite_kernels<unsigned short int>(records, "unsigned short int");
+    suite_kernels<unsigned int>(records, "unsigned int");
+    suite_kernels<unsigned long>(records, "unsigned long");
+    suite_kernels<unsigned long long>(records, "unsigned long long");
+
+    // wide integers
+    suite_kernels<wide_int128>(records, "wide_int128");
+    suite_kernels<wide_int256>(records, "wide_int256");
+    suite_kernels<wide_uint128>(records, "wide_uint128");
+    suite_kernels<wide_uint256>(records, "wide_uint256");
+
+    // real numbers
+    suite_kernels<float>(records, "float");
+    suite_kernels<double>(records, "double");
+    suite_kernels<long double>(records, "long double");
+
+    return records;
+}
+
+/// <summary>
+/// Writes the kernel suite records as a console table, CSV or JSON
+/// </summary>
+/// <param name="records">The measurements</param>
+/// <param name="format">"console", "csv" or "json"</param>
+/// <param name="out">Where the records are written</param>
+void write_benchmark_records(std::vector<benchmark_record> const& records, std::string const& format, std::ostream& out = std::cout)
+{
+    if (format == "csv")
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        out << "type,variant,ns_per_call,ns_per_step" << '\n';
+        for (auto& record : records)
+        {
+            out << record.type << ',' << record.variant << ',' << record.ns_per_call << ',' << record.ns_per_step << '\n';
+        }
     }
-    catch (const std::underflow_error& e) // Catch the thrown exeption if an underflow occurs
+    else if (format == "json")
     {
-        std::cout << e.what() << '\n'; // Display the exception message to the user
+        out << "[" << '\n';
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            out << "  { \"type\": \"" << records[i].type << "\", \"variant\": \"" << records[i].variant
+                << "\", \"ns_per_call\": " << records[i].ns_per_call << ", \"ns_per_step\": " << records[i].ns_per_step
+                << " }" << (i + 1 < records.size() ? "," : "") << '\n';
+        }
+        out << "]" << '\n';
     }
-    catch (const std::exception& e)
+    else
     {
-        std::cout << "ERROR: Unknown Subtraction Error " << e.what() << '\n';
+        out << "Kernel Suite" << std::endl;
+        for (auto& record : records)
+        {
+            out << "\t" << record.type << " " << record.variant << ": " << record.ns_per_call << " ns/call, "
+                << record.ns_per_step << " ns/step" << std::endl;
+        }
+        out << '\n';
     }
-    std::cout << '\n';
 }
 
-void do_overflow_tests(const std::string& star_line)
+void do_benchmarks(const std::string& star_line)
 {
     std::cout << std::endl << star_line << std::endl;
-    std::cout << "*** Running Overflow Tests ***" << std::endl;
+    std::cout << "*** Running Benchmarks ***" << std::endl;
     std::cout << star_line << std::endl;
 
-    /*
-   -------------------------CHANGES---------------------------------------------------
-      Using new template function test_overflow_signed for signed integers
-   -----------------------------------------------------------------------------------
-    */
+    write_benchmark_records(run_kernel_suite(), "console");
 
-    // Testing C++ primitive times see: https://www.geeksforgeeks.org/c-data-types/
-    test_overflow_signed<char>();
-    test_overflow_signed<short int>();
-    test_overflow_signed<int>();
-    test_overflow_signed<long>();
-    test_overflow_signed<long long>();
+    // signed integers
+    benchmark_checked_backends<char>();
+    benchmark_checked_backends<short int>();
+    benchmark_checked_backends<int>();
+    benchmark_checked_backends<long>();
+    benchmark_checked_backends<long long>();
 
     // unsigned integers
-    test_overflow<unsigned char>();
-    test_overflow<wchar_t>();
-    test_overflow<unsigned short int>();
-    test_overflow<unsigned int>();
-    test_overflow<unsigned long>();
-    test_overflow<unsigned long long>();
+    benchmark_checked_backends<unsigned char>();
+    benchmark_checked_backends<wchar_t>();
+    benchmark_checked_backends<unsigned short int>();
+    benchmark_checked_backends<unsigned int>();
+    benchmark_checked_backends<unsigned long>();
+    benchmark_checked_backends<unsigned long long>();
 
-    // real numbers
-    test_overflow<float>();
-    test_overflow<double>();
-    test_overflow<long double>();
-}
+    // checked multiply
+    benchmark_size_computations();
 
-void do_underflow_tests(const std::string& star_line)
-{
-    std::cout << std::endl << star_line << std::endl;
-    std::cout << "*** Running Underflow Tests ***" << std::endl;
-    std::cout << star_line << std::endl;
+    // safe_int
+    benchmark_safe_int<int>();
+    benchmark_safe_int<long long>();
+    benchmark_safe_int<unsigned int>();
 
+    // batched lanes
+    benchmark_batch<char>();
+    benchmark_batch<short int>();
+    benchmark_batch<int>();
+    benchmark_batch<long long>();
+    benchmark_batch<unsigned char>();
+    benchmark_batch<unsigned short int>();
+    benchmark_batch<unsigned int>();
+    benchmark_batch<unsigned long long>();
 
-    // Testing C++ primitive times see: https://www.geeksforgeeks.org/c-data-types/
-    /*
-     -------------------------CHANGES---------------------------------------------------
-        Modified the do_underflow_tests function to call the new test_underflow_signed
-        function in order to actually test signed integer underflow
-     ------------------------------------------------------------------------------------
-    */
-   
-    // signed integers
-    test_underflow_signed<char>();
-    test_underflow_signed<short int>();
-    test_underflow_signed<int>();
-    test_underflow_signed<long>();
-    test_underflow_signed<long long>();
+    // overflow-heavy input mix
+    benchmark_error_reporting<char>();
+    benchmark_error_reporting<int>();
+    benchmark_error_reporting<long long>();
+    benchmark_error_reporting<unsigned int>();
+    benchmark_error_reporting<unsigned long long>();
+    benchmark_telemetry();
 
+    // wide integers
+    benchmark_wide_integers();
 
-    // unsigned integers
-    test_underflow<unsigned char>();
-    test_underflow<wchar_t>();
-    test_underflow<unsigned short int>();
-    test_underflow<unsigned int>();
-    test_underflow<unsigned long>();
-    test_underflow<unsigned long long>();
+    // mixed-type streams
+    benchmark_dispatch();
+
+    // shared counters
+    benchmark_atomic_counters();
 
     // real numbers
-    test_underflow<float>();
-    test_underflow<double>();
-    test_underflow<long double>();
+    benchmark_float_mode<float>();
+    benchmark_float_mode<double>();
+    benchmark_float_mode<long double>();
+    benchmark_chunked_mode<float>();
+    benchmark_chunked_mode<double>();
+    benchmark_chunked_mode<long double>();
+    benchmark_accuracy_modes<float>();
+    benchmark_accuracy_modes<double>();
 }
 
 /// <summary>
 /// Entry point into the application
 /// </summary>
-/// <returns>0 when complete</returns>
-int main()
+/// <param name="argc">The number of command line arguments</param>
+/// <param name="argv">Pass --bench [--csv | --json] to run the benchmarks, --sweep to run the sweeps, --check to run the functional checks or --telemetry to count the test errors instead of printing the tests</param>
+/// <returns>0 when complete, 1 when --sweep or --check found a mismatch or could not run</returns>
+int main(int argc, char* argv[])
 {
     //  create a string of "*" to use in the console
     const std::string star_line = std::string(50, '*');
 
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        // a format on its own writes just the kernel suite for tracking between builds
+        if (argc > 2 && (std::string(argv[2]) == "--csv" || std::string(argv[2]) == "--json"))
+        {
+            write_benchmark_records(run_kernel_suite(), std::string(argv[2]).substr(2));
+            return 0;
+        }
+
+        do_benchmarks(star_line);
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--telemetry")
+    {
+        // run the tests with their report discarded and print only the error counts
+        std::streambuf* console = std::cout.rdbuf(nullptr);
+        do_overflow_tests(star_line);
+        do_underflow_tests(star_line);
+        std::cout.rdbuf(console);
+        std::cout.clear();
+
+        std::cout << "Numeric Error Telemetry" << std::endl;
+        print_numeric_telemetry(numeric_telemetry::snapshot());
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--sweep")
+    {
+        return do_sweeps(star_line) ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--check")
+    {
+        return do_checks(star_line) ? 0 : 1;
+    }
+
     std::cout << "Starting Numeric Underflow / Overflow Tests!" << std::endl;
 
     // run the overflow tests
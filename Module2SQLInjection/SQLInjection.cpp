@@ -2,19 +2,177 @@
 //
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <initializer_list>
 #include <iostream>
+#include <list>
 #include <locale>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
 
 #include "sqlite3.h"
 
-// Helper function to convert a string to lowercase
-std::string toLowerCase(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+/*
+   A set of allowed characters for a user input field, described as up to four
+   inclusive byte ranges so that the validator can test sixteen or thirty two
+   characters at a time with vector range compares. Every byte outside the
+   ranges, including anything above 0x7F, is rejected. Other field validators
+   (a password, a phone number) describe their own class and share
+   validateField instead of writing another character loop. Ranges past the
+   fourth are only checked by the scalar table, which is correct but slower.
+   An inverted range (first > second) allows nothing and is left out of both
+   the ranges and the table; the vector compares would otherwise wrap it
+   around into a range of over two hundred bytes.
+*/
+class CharacterClass
+{
+public:
+    enum { maxRanges = 4 };
+
+    CharacterClass(std::initializer_list<std::pair<unsigned char, unsigned char>> allowed) : rangeCount(0), table()
+    {
+        for (auto& range : allowed)
+        {
+            if (range.first > range.second)
+            {
+                continue;
+            }
+            if (rangeCount < maxRanges)
+            {
+                ranges[rangeCount++] = range;
+            }
+            for (int c = range.first; c <= range.second; ++c)
+            {
+                table[c] = true;
+            }
+        }
+    }
+
+    bool contains(unsigned char c) const
+    {
+        return table[c];
+    }
+
+    int rangeCount;
+    std::array<std::pair<unsigned char, unsigned char>, maxRanges> ranges;
+
+private:
+    std::array<bool, 256> table;
+};
+
+// [0-9A-Za-z], which is what isalnum accepts in the default "C" locale
+const CharacterClass& alphanumericCharacters()
+{
+    static const CharacterClass alphanumeric = { { '0', '9' }, { 'A', 'Z' }, { 'a', 'z' } };
+    return alphanumeric;
+}
+
+/*
+   Range compares for the vector paths. SSE2 and AVX2 only compare signed bytes,
+   so a byte c is inside [lo, hi] when (c - lo) ^ 0x80 is not greater than
+   (hi - lo) ^ 0x80 as a signed byte. Subtracting lo and flipping the top bit is
+   a single add of 0x80 - lo.
+*/
+#if defined(__AVX2__)
+std::size_t validatePrefixAvx2(const unsigned char* input, std::size_t length, const CharacterClass& allowed)
+{
+    __m256i bias[CharacterClass::maxRanges];
+    __m256i limit[CharacterClass::maxRanges];
+    for (int i = 0; i < allowed.rangeCount; ++i)
+    {
+        bias[i] = _mm256_set1_epi8((char)(0x80 - allowed.ranges[i].first));
+        limit[i] = _mm256_set1_epi8((char)((allowed.ranges[i].second - allowed.ranges[i].first) ^ 0x80));
+    }
+
+    std::size_t offset = 0;
+    for (; offset + 32 <= length; offset += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + offset));
+        __m256i outside = _mm256_set1_epi8(-1);
+        for (int i = 0; i < allowed.rangeCount; ++i)
+        {
+            outside = _mm256_and_si256(outside, _mm256_cmpgt_epi8(_mm256_add_epi8(block, bias[i]), limit[i]));
+        }
+        if (_mm256_movemask_epi8(outside) != 0)
+        {
+            break;
+        }
+    }
+    return offset;
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+std::size_t validatePrefixSse2(const unsigned char* input, std::size_t length, const CharacterClass& allowed)
+{
+    __m128i bias[CharacterClass::maxRanges];
+    __m128i limit[CharacterClass::maxRanges];
+    for (int i = 0; i < allowed.rangeCount; ++i)
+    {
+        bias[i] = _mm_set1_epi8((char)(0x80 - allowed.ranges[i].first));
+        limit[i] = _mm_set1_epi8((char)((allowed.ranges[i].second - allowed.ranges[i].first) ^ 0x80));
+    }
+
+    std::size_t offset = 0;
+    for (; offset + 16 <= length; offset += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset));
+        __m128i outside = _mm_set1_epi8(-1);
+        for (int i = 0; i < allowed.rangeCount; ++i)
+        {
+            outside = _mm_and_si128(outside, _mm_cmpgt_epi8(_mm_add_epi8(block, bias[i]), limit[i]));
+        }
+        if (_mm_movemask_epi8(outside) != 0)
+        {
+            break;
+        }
+    }
+    return offset;
+}
+#endif
+
+/*
+   Checks that every character of userInput is in the allowed class. The vector
+   paths validate as many whole 32 and 16 byte blocks as they can and stop at
+   the first block holding a rejected byte; whatever is left is checked one
+   character at a time against the class table.
+*/
+bool validateField(const std::string& userInput, const CharacterClass& allowed)
+{
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(userInput.data());
+    std::size_t length = userInput.length();
+    std::size_t offset = 0;
+
+#if defined(__AVX2__)
+    offset = validatePrefixAvx2(input, length, allowed);
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    offset += validatePrefixSse2(input + offset, length - offset, allowed);
+#endif
+
+    for (; offset < length; ++offset)
+    {
+        if (!allowed.contains(input[offset]))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 /*
@@ -33,34 +191,160 @@ bool whitelistNameField(const std::string& userInput)
           else that is commonoly used in SQL injection we log it as an injection attempt
           and return early without executing the query.
        */
-    for (auto& c : userInput)
+    return validateField(userInput, alphanumericCharacters());
+}
+
+/*
+   Classifies queries against a fixed whitelist in a single pass. The allowed
+   queries are folded to lower case and compiled once into an Aho-Corasick
+   automaton: every state has a precomputed transition for every character
+   class, so a query is scanned one character at a time with one table lookup
+   each, no matter how many queries are allowed, and nothing is allocated. A
+   whitelisted query matches when it appears anywhere in the text, ignoring
+   case, exactly like the substring search it replaces.
+*/
+class QueryWhitelist
+{
+public:
+    explicit QueryWhitelist(const std::vector<std::string>& allowed) : queries(allowed)
     {
-        if (!isalnum(c))
+        // characters that appear in no query all share class 0
+        characterClass.fill(0);
+        classCount = 1;
+        for (auto& q : queries)
         {
-            return false;
+            for (unsigned char c : q)
+            {
+                unsigned char folded = foldCase(c);
+                if (characterClass[folded] == 0)
+                {
+                    characterClass[folded] = classCount++;
+                }
+            }
+        }
+        for (int c = 0; c < 256; ++c)
+        {
+            characterClass[c] = characterClass[foldCase((unsigned char)c)];
+        }
+
+        // build the trie, state 0 is the root
+        transitions.assign(classCount, -1);
+        firstMatch.assign(1, noMatch);
+        for (int i = 0; i < (int)queries.size(); ++i)
+        {
+            int state = 0;
+            for (unsigned char c : queries[i])
+            {
+                int& next = transitions[state * classCount + characterClass[c]];
+                if (next < 0)
+                {
+                    next = (int)firstMatch.size();
+                    transitions.resize(transitions.size() + classCount, -1);
+                    firstMatch.push_back(noMatch);
+                }
+                // resize may have moved the table, so index it again
+                state = transitions[state * classCount + characterClass[c]];
+            }
+            firstMatch[state] = std::min(firstMatch[state], i);
+        }
+
+        // breadth first, fill in the missing transitions from the failure links
+        std::vector<int> failure(firstMatch.size(), 0);
+        std::vector<int> queue;
+        for (int k = 0; k < classCount; ++k)
+        {
+            int& next = transitions[k];
+            if (next < 0)
+            {
+                next = 0;
+            }
+            else
+            {
+                queue.push_back(next);
+            }
+        }
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            const int state = queue[head];
+            // a state also matches every query that ends at its failure state
+            firstMatch[state] = std::min(firstMatch[state], firstMatch[failure[state]]);
+            for (int k = 0; k < classCount; ++k)
+            {
+                int& next = transitions[state * classCount + k];
+                const int fallback = transitions[failure[state] * classCount + k];
+                if (next < 0)
+                {
+                    next = fallback;
+                }
+                else
+                {
+                    failure[next] = fallback;
+                    queue.push_back(next);
+                }
+            }
         }
     }
-    return true;
-}
+
+    /*
+       Returns the index of the first allowed query, in the order they were given,
+       that appears in text, or -1 if none does. With stopAtFirst the scan ends at
+       the first match found, which may not be the first in the list.
+    */
+    int find(const std::string& text, bool stopAtFirst = false) const
+    {
+        int state = 0;
+        int best = noMatch;
+        for (unsigned char c : text)
+        {
+            state = transitions[state * classCount + characterClass[c]];
+            best = std::min(best, firstMatch[state]);
+            if (best != noMatch && (stopAtFirst || best == 0))
+            {
+                break;
+            }
+        }
+        return best == noMatch ? -1 : best;
+    }
+
+    const std::string& query(int index) const
+    {
+        return queries[index];
+    }
+
+private:
+    enum { noMatch = INT_MAX };
+
+    static unsigned char foldCase(unsigned char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (unsigned char)(c - 'A' + 'a') : c;
+    }
+
+    std::vector<std::string> queries;
+    std::array<int, 256> characterClass;
+    int classCount;
+
+    // transitions[state * classCount + class] is the next state
+    std::vector<int> transitions;
+
+    // the lowest index of a query that ends at each state, noMatch for none
+    std::vector<int> firstMatch;
+};
 
 /*
     Currently only two queries are used, and therefore allowed, in this program.
-    More queries can be added to the vector in this function to allow them.
+    More queries can be added to the list in this function to allow them.
 */
-bool validQuery(const std::string& query)
+const QueryWhitelist& allowedQueries()
 {
     // The only acceptable queries
-    std::vector<std::string> validQueries = { "SELECT * from USERS", "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=" };
+    static const QueryWhitelist whitelist({ "SELECT * from USERS", "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=" });
+    return whitelist;
+}
 
+bool validQuery(const std::string& query)
+{
     // Automatically reject any query that is not in the "whitelist"
-    for (auto& q : validQueries)
-    {
-        if (!(toLowerCase(query).find(toLowerCase(q)) == std::string::npos))
-        {
-            return true;
-        }
-    }
-    return false;
+    return allowedQueries().find(query, true) >= 0;
 }
 
 /*
@@ -68,22 +352,342 @@ bool validQuery(const std::string& query)
    Right now we only support one such query but more could be added
    as needed.
 */
-std::string getQuery(const std::string& query)
+const std::string& getQuery(const std::string& query)
 {
-    std::vector<std::string> validQueries = {"SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=" };
-    std::string err = "";
-    
+    static const QueryWhitelist userInputQueries({ "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=" });
+    static const std::string err = "";
+
     // return the query that contains the matching substring
-    for (auto& q : validQueries)
+    const int found = userInputQueries.find(query);
+    return found >= 0 ? userInputQueries.query(found) : err;
+}
+
+/*
+   Prepared statements are expensive to create because sqlite has to parse and
+   plan the query every time. Only a handful of base queries are allowed (see
+   validQuery), so instead of preparing and finalizing a statement on every call
+   run_query keeps the prepared statements in this cache keyed by the base query
+   from getQuery and resets them between uses. The least recently used statement
+   is finalized when the cache is full.
+
+   A statement belongs to the connection that prepared it, so there is one cache
+   per connection, and it must be cleared before the connection is closed
+   because sqlite3_close refuses to close with statements outstanding.
+*/
+class StatementCache
+{
+public:
+    StatementCache(sqlite3* db, std::size_t capacity) : db(db), capacity(capacity) {}
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    ~StatementCache()
+    {
+        clear();
+    }
+
+    /*
+       Returns the statement for baseQuery with a ? placeholder appended,
+       preparing it on a miss. The prepared text is only built on a miss, so a
+       hit does not allocate. The statement is ready for binding and must be
+       handed back with release once the results have been read. Returns
+       nullptr if sqlite cannot prepare the query.
+    */
+    sqlite3_stmt* acquire(const std::string& baseQuery)
     {
-        if (toLowerCase(query).find(toLowerCase(q)) != std::string::npos)
+        auto found = index.find(baseQuery);
+        if (found != index.end())
         {
-            return q;
+            // move the entry to the front of the list as the most recently used
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->second;
         }
+
+        /*
+            NOTE: sqlite3_prepare_v2() takes the length as a signed int. The cast is
+            only okay because the queries that reach this point are the short base
+            queries from getQuery and will never exceed INT_MAX.
+        */
+        const std::string preparedQuery = baseQuery + " ?";
+        sqlite3_stmt* statement = nullptr;
+        if (sqlite3_prepare_v2(db, preparedQuery.c_str(), (int)preparedQuery.length(), &statement, nullptr) != SQLITE_OK)
+        {
+            sqlite3_finalize(statement);
+            return nullptr;
+        }
+
+        if (entries.size() >= capacity)
+        {
+            // evict the least recently used statement
+            sqlite3_finalize(entries.back().second);
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+
+        entries.emplace_front(baseQuery, statement);
+        index[baseQuery] = entries.begin();
+        return statement;
+    }
+
+    /*
+       Resets the statement so it can be run again and drops its bindings so it
+       does not keep pointing at the caller's strings
+    */
+    static void release(sqlite3_stmt* statement)
+    {
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+    }
+
+    // Finalizes every cached statement
+    void clear()
+    {
+        for (auto& entry : entries)
+        {
+            sqlite3_finalize(entry.second);
+        }
+        entries.clear();
+        index.clear();
+    }
+
+private:
+    typedef std::list<std::pair<std::string, sqlite3_stmt*>> EntryList;
+
+    sqlite3* db;
+    std::size_t capacity;
+
+    // most recently used first
+    EntryList entries;
+    std::unordered_map<std::string, EntryList::iterator> index;
+};
+
+// comfortably more than the number of base queries getQuery can return
+const std::size_t statementCacheCapacity = 16;
+
+/*
+   The statement caches of connections that were opened on their own, like the
+   one in main. Pooled connections carry their own cache and never look it up
+   here. The map is still guarded by statementCachesMutex so that separately
+   opened connections can be used from different threads.
+*/
+std::unordered_map<sqlite3*, std::unique_ptr<StatementCache>>& statementCaches()
+{
+    static std::unordered_map<sqlite3*, std::unique_ptr<StatementCache>> caches;
+    return caches;
+}
+
+std::mutex& statementCachesMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Returns the statement cache of a connection, creating it on first use
+StatementCache& statementCacheFor(sqlite3* db)
+{
+    std::lock_guard<std::mutex> lock(statementCachesMutex());
+    std::unique_ptr<StatementCache>& cache = statementCaches()[db];
+    if (!cache)
+    {
+        cache.reset(new StatementCache(db, statementCacheCapacity));
     }
-    return err;
+    return *cache;
+}
+
+// Finalizes the cached statements of a connection, call before sqlite3_close
+void clearStatementCache(sqlite3* db)
+{
+    std::lock_guard<std::mutex> lock(statementCachesMutex());
+    statementCaches().erase(db);
 }
 
+/*
+   A fixed set of connections to one database so that several threads can run
+   queries at the same time. sqlite serializes everything done through a single
+   connection, so each thread leases its own connection from the pool for as
+   long as it is working and hands it back afterwards; a thread that asks when
+   every connection is leased waits for one to be returned.
+
+   The connections only see the same data if they open the same database, so
+   filename is either a shared cache in-memory database
+   ("file:name?mode=memory&cache=shared") or a database file, which is switched
+   to WAL mode so readers do not block each other or the writer. A connection
+   is only ever used by the thread that leased it, so the connections are
+   opened without their own mutex. Each connection owns its statement cache,
+   which is leased along with it, so running a query takes no lock shared
+   with the other threads.
+*/
+class ConnectionPool
+{
+public:
+    // A pooled connection and the statements prepared on it
+    struct Connection
+    {
+        sqlite3* db;
+        std::unique_ptr<StatementCache> statements;
+    };
+
+    ConnectionPool(const std::string& filename, std::size_t size)
+    {
+        // the connections are shared between threads, which needs a thread safe build of sqlite
+        if (sqlite3_threadsafe() == 0)
+        {
+            std::cout << "Failed to create the connection pool. ERROR = sqlite was built without thread support" << std::endl;
+            return;
+        }
+
+        // idle points into connections, so it must not reallocate
+        connections.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            sqlite3* db = nullptr;
+            if (sqlite3_open_v2(filename.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK)
+            {
+                std::cout << "Failed to open a pooled connection. ERROR = " << sqlite3_errmsg(db) << std::endl;
+                sqlite3_close(db);
+                close();
+                return;
+            }
+
+            // wait out the short locks taken while the WAL is checkpointed instead of failing with SQLITE_BUSY
+            sqlite3_busy_timeout(db, 5000);
+            connections.push_back({ db, std::unique_ptr<StatementCache>(new StatementCache(db, statementCacheCapacity)) });
+        }
+
+        /*
+            The journal mode is stored in the database file, in memory databases keep their own
+            journal and report "memory". The pragma returns the mode actually in use, which is
+            not wal when the file cannot be switched (a read only directory, or a filesystem
+            without shared memory), and then the pooled writers would block each other.
+        */
+        if (!connections.empty())
+        {
+            sqlite3* db = connections.front().db;
+            std::string mode;
+            char* error_message = nullptr;
+            auto readMode = [](void* mode, int argc, char** argv, char**) {
+                if (argc > 0 && argv[0] != nullptr)
+                {
+                    *static_cast<std::string*>(mode) = argv[0];
+                }
+                return 0;
+            };
+            if (sqlite3_exec(db, "PRAGMA journal_mode=WAL;", readMode, &mode, &error_message) != SQLITE_OK)
+            {
+                std::cout << "Failed to switch the connection pool to WAL mode. ERROR = " << error_message << std::endl;
+                sqlite3_free(error_message);
+                close();
+                return;
+            }
+
+            const char* file = sqlite3_db_filename(db, "main");
+            if (file != nullptr && file[0] != '\0' && mode != "wal")
+            {
+                std::cout << "Failed to switch the connection pool to WAL mode. ERROR = journal mode is " << mode << std::endl;
+                close();
+                return;
+            }
+        }
+        for (auto& connection : connections)
+        {
+            idle.push_back(&connection);
+        }
+    }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Every connection must have been released
+    ~ConnectionPool()
+    {
+        close();
+    }
+
+    // True when every connection opened
+    bool isOpen() const
+    {
+        return !connections.empty();
+    }
+
+    std::size_t size() const
+    {
+        return connections.size();
+    }
+
+    // Takes a connection out of the pool, waiting until one is free
+    Connection& acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return !idle.empty(); });
+        Connection* connection = idle.back();
+        idle.pop_back();
+        return *connection;
+    }
+
+    // Hands a connection from acquire back to the pool
+    void release(Connection& connection)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(&connection);
+        }
+        available.notify_one();
+    }
+
+private:
+    void close()
+    {
+        for (auto& connection : connections)
+        {
+            // the cached statements have to be finalized before the connection can close
+            connection.statements.reset();
+            sqlite3_close(connection.db);
+        }
+        connections.clear();
+        idle.clear();
+    }
+
+    std::vector<Connection> connections;
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::vector<Connection*> idle;
+};
+
+/*
+   Leases a connection from a pool for the lifetime of the object, so the
+   connection goes back to the pool however the thread's work ends
+*/
+class PooledConnection
+{
+public:
+    explicit PooledConnection(ConnectionPool& pool) : pool(pool), connection(pool.acquire()) {}
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    ~PooledConnection()
+    {
+        pool.release(connection);
+    }
+
+    sqlite3* get() const
+    {
+        return connection.db;
+    }
+
+    // The statement cache of the leased connection, only for the leasing thread
+    StatementCache& statements() const
+    {
+        return *connection.statements;
+    }
+
+private:
+    ConnectionPool& pool;
+    ConnectionPool::Connection& connection;
+};
+
 // DO NOT CHANGE
 typedef std::tuple<std::string, std::string, std::string> user_record;
 const std::string str_where = " where ";
@@ -148,7 +752,19 @@ bool initialize_database(sqlite3* db)
   return true;
 }
 
-bool run_query(sqlite3* db, std::string& sql, std::vector< user_record >& records, bool containsUserInput)
+// Reads a text column of the current row, shown as NULL like the callback does
+std::string columnText(sqlite3_stmt* statement, int column)
+{
+    const unsigned char* text = sqlite3_column_text(statement, column);
+    return text ? reinterpret_cast<const char*>(text) : "NULL";
+}
+
+/*
+   Runs sql on db, preparing user input queries through statements, which must
+   be the statement cache of db. Pooled connections pass the cache they were
+   leased with.
+*/
+bool run_query(sqlite3* db, StatementCache& statements, std::string& sql, std::vector< user_record >& records, bool containsUserInput)
 {
   // TODO: Fix this method to fail and display an error if there is a suspected SQL Injection
   //  NOTE: You cannot just flag 1=1 as an error, since 2=2 will work just as well. You need
@@ -176,7 +792,7 @@ bool run_query(sqlite3* db, std::string& sql, std::vector< user_record >& record
    }
    else // The query contains user input that must be checked
    {
-       std::string baseQuery = getQuery(sql);
+       const std::string& baseQuery = getQuery(sql);
 
        if (baseQuery.length() < 1)
        {
@@ -198,34 +814,22 @@ bool run_query(sqlite3* db, std::string& sql, std::vector< user_record >& record
            return false;
        }
 
-       // Prepared query
-       std::string preparedQuery = baseQuery.append(" ?");
-
        /*
           If the user input has reached this point, it is likely safe, but we will still
           bind the user input into a prepared statement which safeguards against
           all possible injections
        */ 
 
-       // pointer to an sql statement
-       sqlite3_stmt* sqlStatement;
-
        /*
-           Create the prepared statement using the prepared query
-           
-           NOTE: for some reason whoever wrote the sqlite3_prepare_v2()
-           decided to make the string length argument a signed int.
-           To avoid the conversion from size_t to int warning I've used a cast,
-           but this is only okay because we know exactly how long a query that 
-           reaches this part of the code is and it wont exceed INT_MAX.
+           Get the prepared statement for the base query from the cache, which only
+           parses and plans the query the first time it is seen
        */
-       sqlite3_prepare_v2(
-           db,
-           preparedQuery.c_str(),
-           (int)preparedQuery.length(),
-           &sqlStatement,
-           nullptr
-       );
+       sqlite3_stmt* sqlStatement = statements.acquire(baseQuery);
+       if (sqlStatement == nullptr)
+       {
+           std::cout << "Failed to prepare the query. ERROR = " << sqlite3_errmsg(db) << std::endl;
+           return false;
+       }
 
        /*
           Bind the user input text into the prepared query.The user input may or may not contain an SQL injection
@@ -235,32 +839,44 @@ bool run_query(sqlite3* db, std::string& sql, std::vector< user_record >& record
            sqlStatement,
            1,
            userInput.c_str(),
-           (int)preparedQuery.length(),
+           (int)userInput.length(),
            SQLITE_STATIC
        );
 
-       // the final query value
-       std::string query = sqlite3_expanded_sql(sqlStatement);
+       /*
+          Step the bound statement directly and read each row from its columns.
+          Expanding it back to SQL text for sqlite3_exec would make sqlite parse
+          the query a second time.
+       */
+       int stepResult;
+       while ((stepResult = sqlite3_step(sqlStatement)) == SQLITE_ROW)
+       {
+           records.push_back(std::make_tuple(columnText(sqlStatement, 0), columnText(sqlStatement, 1), columnText(sqlStatement, 2)));
+       }
 
-       char* error_message;
-       if (sqlite3_exec(db, query.c_str(), callback, &records, &error_message) != SQLITE_OK)
+       if (stepResult != SQLITE_DONE)
        {
-           std::cout << "Data failed to be queried from USERS table. ERROR = " << error_message << std::endl;
-           sqlite3_free(error_message);
+           std::cout << "Data failed to be queried from USERS table. ERROR = " << sqlite3_errmsg(db) << std::endl;
 
-           // Destroy statement
-           sqlite3_finalize(sqlStatement);
+           // Reset the statement for the next call
+           StatementCache::release(sqlStatement);
 
            return false;
        }
 
-       // Destroy statement
-       sqlite3_finalize(sqlStatement);
+       // Reset the statement for the next call
+       StatementCache::release(sqlStatement);
    }
 
   return true;
 }
 
+// Runs sql on a connection that was opened on its own, see statementCacheFor
+bool run_query(sqlite3* db, std::string& sql, std::vector< user_record >& records, bool containsUserInput)
+{
+  return run_query(db, statementCacheFor(db), sql, records, containsUserInput);
+}
+
 // DO NOT CHANGE
 bool run_query_injection(sqlite3* db, const std::string& sql, std::vector< user_record >& records)
 {
@@ -334,9 +950,340 @@ void run_queries(sqlite3* db)
   }
 }
 
+/*
+   Measures how many user lookups per second run_query can do with the cached,
+   stepped statement, against preparing and finalizing the statement on every
+   lookup and against expanding the cached statement back into SQL text for
+   sqlite3_exec, which is how run_query used to work. Run the program with
+   --bench to see the numbers.
+*/
+bool lookupWithoutCache(sqlite3* db, const std::string& name, std::vector< user_record >& records)
+{
+  records.clear();
+
+  const std::string preparedQuery = "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME= ?";
+  sqlite3_stmt* sqlStatement = nullptr;
+  if (sqlite3_prepare_v2(db, preparedQuery.c_str(), (int)preparedQuery.length(), &sqlStatement, nullptr) != SQLITE_OK)
+  {
+    sqlite3_finalize(sqlStatement);
+    return false;
+  }
+  sqlite3_bind_text(sqlStatement, 1, name.c_str(), (int)name.length(), SQLITE_STATIC);
+
+  char* expandedQuery = sqlite3_expanded_sql(sqlStatement);
+  const bool result = sqlite3_exec(db, expandedQuery, callback, &records, nullptr) == SQLITE_OK;
+  sqlite3_free(expandedQuery);
+  sqlite3_finalize(sqlStatement);
+  return result;
+}
+
+void benchmarkLookups(sqlite3* db)
+{
+  const int lookups = 100000;
+  const std::string names[] = { "Fred", "Barney", "Wilma", "Betty" };
+  const std::string baseQuery = "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=";
+  std::vector< user_record > records;
+
+  std::cout << std::endl << "Lookup Benchmark (" << lookups << " lookups)" << std::endl;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+  {
+    lookupWithoutCache(db, names[i % 4], records);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "\tprepare per call: " << lookups / std::chrono::duration<double>(end - begin).count() << " lookups/sec" << std::endl;
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+  {
+    records.clear();
+    sqlite3_stmt* sqlStatement = statementCacheFor(db).acquire(baseQuery);
+    sqlite3_bind_text(sqlStatement, 1, names[i % 4].c_str(), (int)names[i % 4].length(), SQLITE_STATIC);
+    char* expandedQuery = sqlite3_expanded_sql(sqlStatement);
+    sqlite3_exec(db, expandedQuery, callback, &records, nullptr);
+    sqlite3_free(expandedQuery);
+    StatementCache::release(sqlStatement);
+  }
+  end = std::chrono::steady_clock::now();
+  std::cout << "\tcached, expanded: " << lookups / std::chrono::duration<double>(end - begin).count() << " lookups/sec" << std::endl;
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+  {
+    std::string sql = "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME='" + names[i % 4] + "'";
+    run_query(db, sql, records, true);
+  }
+  end = std::chrono::steady_clock::now();
+  std::cout << "\trun_query:        " << lookups / std::chrono::duration<double>(end - begin).count() << " lookups/sec" << std::endl;
+}
+
+/*
+   Compares the whitelist automaton against the linear scan validQuery used to do,
+   which lower cased the query once per allowed query and searched for each in
+   turn, with a whitelist of a few hundred queries
+*/
+void benchmarkWhitelist()
+{
+  const int classifications = 20000;
+
+  std::vector<std::string> allowed;
+  for (int i = 0; i < 300; ++i)
+  {
+    allowed.push_back("SELECT VALUE" + std::to_string(i) + " FROM TABLE" + std::to_string(i) + " WHERE ID=");
+  }
+  allowed.push_back("SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME=");
+
+  const std::string queries[] = {
+    "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME='Fred'",
+    "select value150 from table150 where id=7",
+    "DROP TABLE USERS"
+  };
+
+  std::cout << std::endl << "Whitelist Benchmark (" << allowed.size() << " allowed queries)" << std::endl;
+
+  auto lower = [](std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+  };
+
+  std::size_t scanned = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < classifications; ++i)
+  {
+    const std::string& query = queries[i % 3];
+    for (auto& q : allowed)
+    {
+      if (lower(query).find(lower(q)) != std::string::npos)
+      {
+        ++scanned;
+        break;
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "\tlinear scan: " << classifications / std::chrono::duration<double>(end - begin).count() << " queries/sec" << std::endl;
+
+  std::size_t found = 0;
+  const QueryWhitelist whitelist(allowed);
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < classifications; ++i)
+  {
+    found += whitelist.find(queries[i % 3], true) >= 0;
+  }
+  end = std::chrono::steady_clock::now();
+  std::cout << "\tautomaton:   " << classifications / std::chrono::duration<double>(end - begin).count() << " queries/sec" << std::endl;
+
+  if (found != scanned)
+  {
+    std::cout << "\tthe scans disagree!" << std::endl;
+  }
+}
+
+/*
+   Measures how fast user supplied names are validated in bulk, from 1 KB to
+   1 MB of input, with the isalnum loop whitelistNameField used to run against
+   the vectorized validateField. The inputs are entirely alphanumeric so both
+   have to look at every character.
+*/
+void benchmarkNameValidation()
+{
+  const std::size_t totalBytes = 64 * 1024 * 1024;
+  const std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+  std::cout << std::endl << "Name Validation Benchmark" << std::endl;
+
+  for (std::size_t size = 1024; size <= 1024 * 1024; size *= 4)
+  {
+    std::string input(size, ' ');
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      input[i] = alphabet[i % alphabet.length()];
+    }
+    const std::size_t passes = totalBytes / size;
+
+    std::size_t scalarValid = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass)
+    {
+      bool valid = true;
+      for (auto& c : input)
+      {
+        if (!isalnum(c))
+        {
+          valid = false;
+          break;
+        }
+      }
+      scalarValid += valid;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double scalarSeconds = std::chrono::duration<double>(end - begin).count();
+
+    std::size_t vectorValid = 0;
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass)
+    {
+      vectorValid += validateField(input, alphanumericCharacters());
+    }
+    end = std::chrono::steady_clock::now();
+    double vectorSeconds = std::chrono::duration<double>(end - begin).count();
+
+    std::cout << "\t" << size / 1024 << " KB: isalnum " << totalBytes / scalarSeconds / (1024 * 1024) << " MB/sec, "
+      << "vectorized " << totalBytes / vectorSeconds / (1024 * 1024) << " MB/sec" << std::endl;
+
+    if (scalarValid != passes || vectorValid != passes)
+    {
+      std::cout << "\tthe validators disagree!" << std::endl;
+    }
+  }
+}
+
+/*
+   Checks the vectorized validateField against a plain per-byte loop. Every
+   field length up to a few vector widths is tried, both all valid and with
+   one bad byte at each position, so the SSE2/AVX2 blocks and the scalar tail
+   are all covered. Prints each mismatch and returns the number of failures.
+*/
+int checkNameValidation()
+{
+  int failures = 0;
+  auto expect = [&failures](bool condition, const std::string& what) {
+    if (!condition)
+    {
+      std::cout << "\tFAILED: " << what << std::endl;
+      ++failures;
+    }
+  };
+
+  // an inverted range allows nothing, whichever path checks the field
+  const CharacterClass inverted{ { 'z', 'a' } };
+  const CharacterClass invertedAndDigits{ { 'z', 'a' }, { '0', '9' } };
+  for (std::size_t length = 1; length <= 64; ++length)
+  {
+    expect(!validateField(std::string(length, '='), inverted),
+      "inverted range accepts " + std::to_string(length) + " '=' bytes");
+    expect(validateField(std::string(length, '7'), invertedAndDigits),
+      "inverted range rejects " + std::to_string(length) + " digits");
+    expect(!validateField(std::string(length, 'm'), invertedAndDigits),
+      "inverted range accepts " + std::to_string(length) + " 'm' bytes");
+  }
+
+  // every byte value against isalnum, alone and inside valid fields
+  const CharacterClass& alphanumeric = alphanumericCharacters();
+  for (int c = 0; c < 256; ++c)
+  {
+    const bool allowed = isalnum(c) != 0;
+    for (std::size_t length : { 1, 15, 16, 17, 31, 32, 33, 64 })
+    {
+      for (std::size_t position : { (std::size_t)0, length / 2, length - 1 })
+      {
+        std::string field(length, 'a');
+        field[position] = (char)c;
+        expect(validateField(field, alphanumeric) == allowed,
+          "byte " + std::to_string(c) + " at " + std::to_string(position) + " of " + std::to_string(length));
+      }
+    }
+  }
+
+  return failures;
+}
+
+/*
+   Measures how run_query scales with the number of threads sharing a
+   connection pool, from one thread up to the number of cores (and at least
+   four threads so the effect of oversubscribing is visible on small
+   machines). The same number of lookups is split evenly between the threads,
+   once against a shared cache in-memory database and once against a WAL
+   database file, which is deleted afterwards.
+*/
+void benchmarkConnectionPool()
+{
+  const int lookups = 100000;
+  const std::string names[] = { "Fred", "Barney", "Wilma", "Betty" };
+  const unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+  const std::string databaseFile = "sqlinjection_pool.db";
+
+  // doubling from one thread, and always ending at maxThreads even when it is
+  // not a power of two, so every core is measured
+  std::vector<unsigned> threadCounts;
+  for (unsigned threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+  {
+    threadCounts.push_back(threadCount);
+  }
+  threadCounts.push_back(maxThreads);
+
+  const std::pair<std::string, std::string> databases[] = {
+    { "shared cache", "file:sqlinjection_pool?mode=memory&cache=shared" },
+    { "WAL file", databaseFile }
+  };
+
+  std::cout << std::endl << "Connection Pool Benchmark (" << lookups << " lookups)" << std::endl;
+
+  auto removeDatabaseFile = [&databaseFile] {
+    std::remove(databaseFile.c_str());
+    std::remove((databaseFile + "-wal").c_str());
+    std::remove((databaseFile + "-shm").c_str());
+  };
+
+  for (auto& database : databases)
+  {
+    removeDatabaseFile();
+
+    ConnectionPool pool(database.second, maxThreads);
+    bool initialized = false;
+    if (pool.isOpen())
+    {
+      PooledConnection connection(pool);
+      initialized = initialize_database(connection.get());
+    }
+
+    if (initialized)
+    {
+      std::cout << "\t" << database.first << std::endl;
+      for (unsigned threadCount : threadCounts)
+      {
+        std::vector<std::thread> threads;
+        std::vector<int> failures(threadCount, 0);
+
+        auto begin = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; ++t)
+        {
+          threads.emplace_back([&, t] {
+            PooledConnection connection(pool);
+            std::vector< user_record > records;
+            for (int i = (int)t; i < lookups; i += (int)threadCount)
+            {
+              std::string sql = "SELECT ID, NAME, PASSWORD FROM USERS WHERE NAME='" + names[i % 4] + "'";
+              if (!run_query(connection.get(), connection.statements(), sql, records, true) || records.size() != 1)
+              {
+                ++failures[t];
+              }
+            }
+          });
+        }
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << "\t\t" << threadCount << " threads: " << lookups / std::chrono::duration<double>(end - begin).count() << " lookups/sec" << std::endl;
+
+        if (std::count(failures.begin(), failures.end(), 0) != (std::ptrdiff_t)threadCount)
+        {
+          std::cout << "\t\tsome lookups failed!" << std::endl;
+        }
+      }
+    }
+  }
+
+  removeDatabaseFile();
+}
+
 // You can change main by adding stuff to it, but all of the existing code must remain, and be in the
 // in the order called, and with none of this existing code placed into conditional statements
-int main()
+int main(int argc, char* argv[])
 {
   // initialize random seed:
   srand((unsigned int)time(nullptr));
@@ -368,8 +1315,31 @@ int main()
   else
   {
     run_queries(db);
+
+    // --bench measures the lookup rate after the normal run
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+      benchmarkLookups(db);
+      benchmarkWhitelist();
+      benchmarkNameValidation();
+      benchmarkConnectionPool();
+    }
+
+    // --check compares the vectorized validators with the scalar ones
+    if (argc > 1 && std::string(argv[1]) == "--check")
+    {
+      const int failures = checkNameValidation();
+      std::cout << std::endl << "Name validation checks: " << failures << " failures" << std::endl;
+      if (failures != 0)
+      {
+        return_code = 1;
+      }
+    }
   }
 
+  // the cached statements have to be finalized before the connection can close
+  clearStatementCache(db);
+
   // close the connection if opened
   if(db != NULL)
   {